@@ -6,6 +6,8 @@ layout(location = 0) out vec4 color; // Final result.
 in vec2 v_TexCoord; 
 in vec3 v_fragPos;
 in vec3 v_normal;
+flat in int v_tiledTexCoord;
+flat in vec2 v_textureTile;
 
 // Uniforms.
 uniform vec3 u_sunLightPos;
@@ -13,6 +15,7 @@ uniform vec3 u_viewPos;
 uniform sampler2D u_Texture;
 uniform int u_renderMode;
 uniform int u_useComplexLighting;
+uniform int u_blockAtlasResolution;
 
 // Local variables.
 vec4 ambient = vec4(0.6, 0.6, 0.6, 1);
@@ -23,12 +26,22 @@ float distance = length(u_sunLightPos - v_fragPos);
 // Main.
 void main() {
 	
-	if (u_renderMode == 0) {
+	if (u_renderMode != 1) {
 	
 		/*
 		3D rendering.
 		*/
 
+		// Tiled texture coordinates are face-local, so their fractional part
+		// gives the position inside the texture's tile in the atlas.
+		vec2 texCoord = v_TexCoord;
+		if (v_tiledTexCoord == 1) {
+
+			vec2 tileSize = vec2(u_blockAtlasResolution) / vec2(textureSize(u_Texture, 0));
+			texCoord = (v_textureTile + fract(v_TexCoord)) * tileSize;
+
+		}
+
 		// Diffuse lighting calculation.
 		vec3 norm = normalize(vec3((v_normal.x - 511) / 511, (v_normal.y - 511) / 511, (v_normal.z - 511) / 511));
 		vec3 lightDir = normalize(u_sunLightPos - v_fragPos);
@@ -49,7 +62,7 @@ void main() {
 		vec4 specularLighting = vec4(specularStrength * specular * lightColor, 1.0);
 
 		// Final color calculation.
-		color = (ambient + (diffuseLighting + specularLighting) * u_useComplexLighting) * texture(u_Texture, v_TexCoord);
+		color = (ambient + (diffuseLighting + specularLighting) * u_useComplexLighting) * texture(u_Texture, texCoord);
 	
 	}
 	else {
@@ -14,16 +14,28 @@
 layout(location = 0) in vec4 position; // Vertices' positions.
 layout(location = 1) in vec2 texCoord;
 layout(location = 2) in vec3 normal;
+layout(location = 3) in uvec2 packedVertex; // Chunks' vertices (see the 'chunkVertex' struct).
 
 // This are output varying variables. These are variables that are shared between shader programs.
 out vec2 v_TexCoord;
 out vec3 v_fragPos;
 out vec3 v_normal;
+flat out int v_tiledTexCoord;
+flat out vec2 v_textureTile;
 
 uniform vec3 u_sunLightPos;
 uniform int u_renderMode;
 uniform mat4 u_MVP; // u_MVP stands for u_Model_view_projection_matrix although only the view and projection matrix are currently used.
 uniform mat4 u_MVPGUI;
+uniform samplerBuffer u_chunkPageOrigins; // Position of the origin of the chunk that owns each page of the terrain vertex arena.
+uniform sampler2D u_Texture;
+uniform int u_blockAtlasResolution;
+
+// Number of vertices in each page of the terrain vertex arena (see TERRAIN_ARENA_PAGE_SIZE).
+const int arenaPageSize = 128;
+
+// Normals of the block faces in the order used by chunks' vertices.
+const vec3 faceNormals[6] = vec3[6](vec3(0, 0, 1), vec3(0, 0, -1), vec3(0, 1, 0), vec3(0, -1, 0), vec3(1, 0, 0), vec3(-1, 0, 0));
 
 
 
@@ -39,9 +51,37 @@ void main() {
 		v_fragPos = position.xyz;
 
 		v_normal = mat3(transpose(inverse(mat3(1)))) * normal;
+		v_tiledTexCoord = 0;
 	
 		gl_Position = u_MVP * position;
 
+	}
+	else if (u_renderMode == 2) {
+
+		/*
+		3D rendering of chunks.
+		*/
+		// Unpack the vertex. Its chunk's origin is given by the arena page the vertex is stored in.
+		vec3 chunkOrigin = texelFetch(u_chunkPageOrigins, gl_VertexID / arenaPageSize).xyz;
+		vec4 chunkPosition = vec4(chunkOrigin + vec3(packedVertex.x & 31u, (packedVertex.x >> 5) & 31u, (packedVertex.x >> 10) & 31u), 1.0);
+		uint face = (packedVertex.x >> 15) & 7u;
+
+		// Export variables to fragment shader.
+		// The face-local texture coordinates repeat the texture once per block.
+		v_TexCoord = vec2((packedVertex.x >> 18) & 31u, (packedVertex.x >> 23) & 31u);
+		// The texture is placed one tile before the one given by its ID, wrapping around the atlas,
+		// following the same mapping as models::addTexture.
+		uvec2 nTiles = uvec2(textureSize(u_Texture, 0) / u_blockAtlasResolution);
+		v_textureTile = vec2((packedVertex.y % nTiles.x + nTiles.x - 1u) % nTiles.x,
+							 ((packedVertex.y + nTiles.y - 1u) / nTiles.y + nTiles.y - 1u) % nTiles.y);
+		v_tiledTexCoord = 1;
+		v_fragPos = chunkPosition.xyz;
+
+		// Normals are exported with the same encoding as the non-chunk vertices' ones.
+		v_normal = faceNormals[face] * 511.0 + 511.0;
+
+		gl_Position = u_MVP * chunkPosition;
+
 	}
 	else {
 	
@@ -49,6 +89,7 @@ void main() {
 		2D rendering.
 		*/
 		v_TexCoord = texCoord;
+		v_tiledTexCoord = 0;
 
 		gl_Position = u_MVPGUI * vec4(position.xy, 0.0, 1.0);
 	
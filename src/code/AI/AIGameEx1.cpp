@@ -278,14 +278,19 @@ namespace AIExample {
 
 	// 'miningWorldGen' class.
 
-	const std::uniform_int_distribution<unsigned int> miningWorldGen::int6Dice_(1, 6);
-	std::uniform_int_distribution<unsigned int> miningWorldGen::intDice_(1, 100);
-	std::uniform_real_distribution<float> miningWorldGen::floatDice_(1.0f, 100.f);
+	thread_local std::uniform_int_distribution<unsigned int> miningWorldGen::int6Dice_(1, 6);
+	thread_local std::uniform_int_distribution<unsigned int> miningWorldGen::intDice_(1, 100);
+	thread_local std::uniform_real_distribution<float> miningWorldGen::floatDice_(1.0f, 100.f);
 
 
 	void miningWorldGen::prepareGen_() {
 
-		chunkColHeight_.clear();
+		{
+
+			std::unique_lock<std::shared_mutex> lock(chunkColHeightMutex_);
+			chunkColHeight_.clear();
+
+		}
 
 		if (!VoxelEng::game::selectedSaveSlot() && VoxelEng::chunkManager::openedTerrainFileName().empty())
 			setSeed();
@@ -311,37 +316,49 @@ namespace AIExample {
 				       blockPos;
 		VoxelEng::vec3 inChunkPos;
 		const chunkHeightMap& heightMap = chunkHeightMap_(chunkPos.x, chunkPos.z);
+		std::vector<oreCascade> cascades;
 
-		for (inChunkPos.x = 0; inChunkPos.x < VoxelEng::SCX; inChunkPos.x++)
-			for (inChunkPos.z = 0; inChunkPos.z < VoxelEng::SCZ; inChunkPos.z++)
-				for (inChunkPos.y = 0; inChunkPos.y < VoxelEng::SCY; inChunkPos.y++) {
+		{
 
-					if (!chunk.getBlock(inChunkPos)) {
+			VoxelEng::chunkEditSession session(chunk);
 
-						blockPos = VoxelEng::chunkManager::getGlobalPos(chunkPos, inChunkPos);
+			for (inChunkPos.x = 0; inChunkPos.x < VoxelEng::SCX; inChunkPos.x++)
+				for (inChunkPos.z = 0; inChunkPos.z < VoxelEng::SCZ; inChunkPos.z++)
+					for (inChunkPos.y = 0; inChunkPos.y < VoxelEng::SCY; inChunkPos.y++) {
 
-						if (blockPos.y < heightMap[inChunkPos.x][inChunkPos.z] - 3) {
+						if (!session.getBlock(inChunkPos)) {
 
-							if (blockPos.y > 30 && floatDice_(generator_) <= 1.05f)
-								generateOre_(inChunkPos, chunk, ore::COAL);
-							else if (blockPos.y <= 35 && blockPos.y > 10 && floatDice_(generator_) <= 1.05f)
-								generateOre_(inChunkPos, chunk, ore::IRON);
-							else if (blockPos.y <= 15 && blockPos.y > -10 && floatDice_(generator_) <= 1.01f)
-								generateOre_(inChunkPos, chunk, ore::GOLD);
-							else if (blockPos.y <= -5 && blockPos.y > -20 && floatDice_(generator_) <= 1.005f)
-								generateOre_(inChunkPos, chunk, ore::DIAMOND);
-							else
-								chunk.setBlock(inChunkPos.x, inChunkPos.y, inChunkPos.z, 2);
+							blockPos = VoxelEng::chunkManager::getGlobalPos(chunkPos, inChunkPos);
+
+							if (blockPos.y < heightMap[inChunkPos.x][inChunkPos.z] - 3) {
+
+								if (blockPos.y > 30 && floatDice_(chunkGenerator_) <= 1.05f)
+									generateOre_(inChunkPos, session, ore::COAL, cascades);
+								else if (blockPos.y <= 35 && blockPos.y > 10 && floatDice_(chunkGenerator_) <= 1.05f)
+									generateOre_(inChunkPos, session, ore::IRON, cascades);
+								else if (blockPos.y <= 15 && blockPos.y > -10 && floatDice_(chunkGenerator_) <= 1.01f)
+									generateOre_(inChunkPos, session, ore::GOLD, cascades);
+								else if (blockPos.y <= -5 && blockPos.y > -20 && floatDice_(chunkGenerator_) <= 1.005f)
+									generateOre_(inChunkPos, session, ore::DIAMOND, cascades);
+								else
+									session.setBlock(inChunkPos.x, inChunkPos.y, inChunkPos.z, 2);
+
+							}
+							else if (blockPos.y >= heightMap[inChunkPos.x][inChunkPos.z] - 3 && blockPos.y < heightMap[inChunkPos.x][inChunkPos.z])
+								session.setBlock(inChunkPos.x, inChunkPos.y, inChunkPos.z, 6);
+							else if (blockPos.y == heightMap[inChunkPos.x][inChunkPos.z])
+								session.setBlock(inChunkPos.x, inChunkPos.y, inChunkPos.z, 1);
 
 						}
-						else if (blockPos.y >= heightMap[inChunkPos.x][inChunkPos.z] - 3 && blockPos.y < heightMap[inChunkPos.x][inChunkPos.z])
-							chunk.setBlock(inChunkPos.x, inChunkPos.y, inChunkPos.z, 6);
-						else if (blockPos.y == heightMap[inChunkPos.x][inChunkPos.z])
-							chunk.setBlock(inChunkPos.x, inChunkPos.y, inChunkPos.z, 1);
 
 					}
 
-				}
+		}
+
+		// The ores that spread into neighbor chunks are generated once the chunk's edit session has
+		// released it, so that two neighbor chunks generated at the same time cannot wait for each other.
+		for (oreCascade& cascade : cascades)
+			cascadeOreGen_(cascade.chunkPos, cascade.nBlocksCounter, cascade.nBlocks, cascade.inChunkX, cascade.inChunkY, cascade.inChunkZ, cascade.oreID);
 
 		chunk.setLoadLevel(VoxelEng::chunkLoadLevel::DECORATED);
 
@@ -351,16 +368,30 @@ namespace AIExample {
 
 		VoxelEng::vec2 chunkXZPos(chunkX, chunkZ);
 
-		if (chunkColHeight_.find(chunkXZPos) == chunkColHeight_.cend())
-			generateChunkHeightMap_(chunkXZPos);
+		{
+
+			std::shared_lock<std::shared_mutex> lock(chunkColHeightMutex_);
+
+			auto it = chunkColHeight_.find(chunkXZPos);
+			if (it != chunkColHeight_.cend())
+				return it->second;
+
+		}
+
+		// The height map is computed without holding the lock. If another thread stored the
+		// same chunk column's height map in the meantime, that one is kept.
+		// References to the map's elements remain valid when other elements are inserted.
+		chunkHeightMap heights;
+		generateChunkHeightMap_(chunkXZPos, heights);
+
+		std::unique_lock<std::shared_mutex> lock(chunkColHeightMutex_);
 
-		return chunkColHeight_[chunkXZPos];
+		return chunkColHeight_.try_emplace(chunkXZPos, heights).first->second;
 	
 	}
 
-	void miningWorldGen::generateChunkHeightMap_(const VoxelEng::vec2& chunkXZPos) {
+	void miningWorldGen::generateChunkHeightMap_(const VoxelEng::vec2& chunkXZPos, chunkHeightMap& heights) {
 
-		chunkHeightMap& heights = chunkColHeight_[chunkXZPos] = std::array<std::array<int, VoxelEng::SCZ>, VoxelEng::SCX>();
 		float softnessFactor = 64.0f,
 			  height;
 		VoxelEng::vec2 pos,
@@ -393,7 +424,7 @@ namespace AIExample {
 	
 	}
 
-	void miningWorldGen::generateOre_(VoxelEng::vec3 inChunkPos, VoxelEng::chunk& chunk, ore ore) {
+	void miningWorldGen::generateOre_(VoxelEng::vec3 inChunkPos, VoxelEng::chunkEditSession& chunk, ore ore, std::vector<oreCascade>& cascades) {
 
 		std::uniform_int_distribution<unsigned int>::param_type* oreSpread = nullptr;
 		VoxelEng::block oreID = 0;
@@ -430,7 +461,7 @@ namespace AIExample {
 
 		}
 
-		unsigned int nBlocks = intDice_(generator_, *oreSpread);
+		unsigned int nBlocks = intDice_(chunkGenerator_, *oreSpread);
 		VoxelEng::vec3 cPos;
 		for (unsigned int i = 0; i < nBlocks; i++) {
 
@@ -438,14 +469,14 @@ namespace AIExample {
 
 				chunk.setBlock(inChunkPos.x, inChunkPos.y, inChunkPos.z, oreID);
 
-				switch (int6Dice_(generator_)) {
+				switch (int6Dice_(chunkGenerator_)) {
 
 				case 1:
 
 					if (inChunkPos.x + 1 >= VoxelEng::SCX) {
 
 						if (VoxelEng::chunkManager::isChunkInWorld(cPos = chunk.chunkPos() + VoxelEng::vec3FixedNorth))
-							cascadeOreGen_(cPos, i, nBlocks, 0, inChunkPos.y, inChunkPos.z, oreID);
+							cascades.push_back({ cPos, i, nBlocks, 0, static_cast<unsigned int>(inChunkPos.y), static_cast<unsigned int>(inChunkPos.z), oreID });
 						
 						i = nBlocks;
 
@@ -460,7 +491,7 @@ namespace AIExample {
 					if (inChunkPos.x == 0) {
 
 						if (VoxelEng::chunkManager::isChunkInWorld(cPos = chunk.chunkPos() + VoxelEng::vec3FixedSouth))
-							cascadeOreGen_(cPos, i, nBlocks, VoxelEng::SCX - 1, inChunkPos.y, inChunkPos.z, oreID);
+							cascades.push_back({ cPos, i, nBlocks, VoxelEng::SCX - 1, static_cast<unsigned int>(inChunkPos.y), static_cast<unsigned int>(inChunkPos.z), oreID });
 						
 						i = nBlocks;
 
@@ -475,7 +506,7 @@ namespace AIExample {
 					if (inChunkPos.y + 1 >= VoxelEng::SCY) {
 
 						if (VoxelEng::chunkManager::isChunkInWorld(cPos = chunk.chunkPos() + VoxelEng::vec3FixedUp))
-							cascadeOreGen_(cPos, i, nBlocks, inChunkPos.x, 0, inChunkPos.z, oreID);
+							cascades.push_back({ cPos, i, nBlocks, static_cast<unsigned int>(inChunkPos.x), 0, static_cast<unsigned int>(inChunkPos.z), oreID });
 						
 						i = nBlocks;
 
@@ -490,7 +521,7 @@ namespace AIExample {
 					if (inChunkPos.y == 0) {
 
 						if (VoxelEng::chunkManager::isChunkInWorld(cPos = chunk.chunkPos() + VoxelEng::vec3FixedDown))
-							cascadeOreGen_(cPos, i, nBlocks, inChunkPos.x, VoxelEng::SCY - 1, inChunkPos.z, oreID);
+							cascades.push_back({ cPos, i, nBlocks, static_cast<unsigned int>(inChunkPos.x), VoxelEng::SCY - 1, static_cast<unsigned int>(inChunkPos.z), oreID });
 						
 						i = nBlocks;
 
@@ -505,7 +536,7 @@ namespace AIExample {
 					if (inChunkPos.z + 1 >= VoxelEng::SCZ) {
 
 						if (VoxelEng::chunkManager::isChunkInWorld(cPos = chunk.chunkPos() + VoxelEng::vec3FixedEast))
-							cascadeOreGen_(cPos, i, nBlocks, inChunkPos.x, inChunkPos.y, 0, oreID);
+							cascades.push_back({ cPos, i, nBlocks, static_cast<unsigned int>(inChunkPos.x), static_cast<unsigned int>(inChunkPos.y), 0, oreID });
 
 						i = nBlocks;
 
@@ -520,9 +551,9 @@ namespace AIExample {
 					if (inChunkPos.z == 0) {
 
 						if (VoxelEng::chunkManager::isChunkInWorld(cPos = chunk.chunkPos() + VoxelEng::vec3FixedWest))
-							cascadeOreGen_(cPos, i, nBlocks, inChunkPos.x, inChunkPos.y, VoxelEng::SCZ - 1, oreID);
-						else
-							i = nBlocks;
+							cascades.push_back({ cPos, i, nBlocks, static_cast<unsigned int>(inChunkPos.x), static_cast<unsigned int>(inChunkPos.y), VoxelEng::SCZ - 1, oreID });
+
+						i = nBlocks;
 
 					}
 					else
@@ -541,6 +572,7 @@ namespace AIExample {
 	void miningWorldGen::cascadeOreGen_(const VoxelEng::vec3 chunkPos, unsigned int& nBlocksCounter, unsigned int nBlocks,
 		unsigned int inChunkX, unsigned int inChunkY, unsigned int inChunkZ, VoxelEng::block oreID) {
 
+		VoxelEng::chunkReadGuard guard; // The cascade chunk cannot be reused while ores are spread in it.
 		VoxelEng::chunk* cascadeChunk = nullptr;
 		if (VoxelEng::chunkManager::getChunkLoadLevel(chunkPos) == VoxelEng::chunkLoadLevel::NOTLOADED)
 			cascadeChunk = VoxelEng::chunkManager::createChunk(true, chunkPos);
@@ -553,7 +585,7 @@ namespace AIExample {
 
 				cascadeChunk->setBlock(inChunkX, inChunkY, inChunkZ, oreID);
 
-				switch (spreadDirection = int6Dice_(generator_)) {
+				switch (spreadDirection = int6Dice_(chunkGenerator_)) {
 
 					case 1:
 
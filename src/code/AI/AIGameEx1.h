@@ -9,7 +9,9 @@
 #ifndef _AIEXAMPLE_EX1_
 #define _AIEXAMPLE_EX1_
 #include <string>
+#include <shared_mutex>
 #include <unordered_map>
+#include <vector>
 #include <array>
 #include <arrayfire.h>
 #include "af/random.h"
@@ -86,14 +88,31 @@ namespace AIExample {
 		Attributes.
 		*/
 
-		static const std::uniform_int_distribution<unsigned int> int6Dice_;
-		static std::uniform_int_distribution<unsigned int> intDice_;
-		static std::uniform_real_distribution<float> floatDice_;
+		/*
+		Ore blocks left to spread into a neighbor chunk once the chunk being generated is no longer locked.
+		*/
+		struct oreCascade {
+
+			VoxelEng::vec3 chunkPos;
+			unsigned int nBlocksCounter,
+						 nBlocks,
+						 inChunkX,
+						 inChunkY,
+						 inChunkZ;
+			VoxelEng::block oreID;
+
+		};
+
+		// Chunks are generated on several threads at once, so each thread has its own distributions.
+		static thread_local std::uniform_int_distribution<unsigned int> int6Dice_;
+		static thread_local std::uniform_int_distribution<unsigned int> intDice_;
+		static thread_local std::uniform_real_distribution<float> floatDice_;
 
 		bool spawnSet_;
 		int maxBlockYCoord_;
 		VoxelEng::vec3 AISpawnPos_; // Same spawn position for every AI agent.
 		std::unordered_map<VoxelEng::vec2, chunkHeightMap> chunkColHeight_;
+		std::shared_mutex chunkColHeightMutex_;
 		std::uniform_int_distribution<unsigned int>::param_type coalSpreadRange_,
 																ironSpreadRange_,
 																goldSpreadRange_,
@@ -124,12 +143,17 @@ namespace AIExample {
 		*/
 		const chunkHeightMap& chunkHeightMap_(const VoxelEng::vec2& blockXZPos);
 
-		void generateChunkHeightMap_(const VoxelEng::vec2& chunkXZPos);
+		/*
+		Computes the height map of the specified chunk column into 'heights'.
+		*/
+		void generateChunkHeightMap_(const VoxelEng::vec2& chunkXZPos, chunkHeightMap& heights);
 
 		/*
 		'inChunkX', 'inChunkY' and 'inChunkZ' serve as the starting point to generate the ore.
+		The ore blocks that spread into a neighbor chunk are added to 'cascades' instead, as
+		neighbor chunks cannot be locked while 'chunk' is.
 		*/
-		void generateOre_(VoxelEng::vec3 inChunkPos, VoxelEng::chunk& chunk, ore ore);
+		void generateOre_(VoxelEng::vec3 inChunkPos, VoxelEng::chunkEditSession& chunk, ore ore, std::vector<oreCascade>& cascades);
 
 	};
 
@@ -1,9 +1,19 @@
 #include "batch.h"
+#include <algorithm>
 #include <string>
 #include <iterator>
+#include <limits>
 #include "definitions.h"
 #include "logger.h"
 
+// SSE is always available on x64 builds.
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+
+#define VOXELENG_BATCH_SSE
+#include <xmmintrin.h>
+
+#endif
+
 
 namespace VoxelEng {
 
@@ -11,10 +21,11 @@ namespace VoxelEng {
 	// 'batch' class.
 
 	batch::batch() 
-	: dirty_(false) {}
+	: dirty_(false), boxMin_(vec3Zero), boxMax_(vec3Zero) {}
 
 	batch::batch(const batch& b) 
-	: dirty_(b.dirty_.load()), activeEntityID_(b.activeEntityID_), inactiveEntityID_(b.inactiveEntityID_), model_(b.model_) {}
+	: dirty_(b.dirty_.load()), activeEntityID_(b.activeEntityID_), inactiveEntityID_(b.inactiveEntityID_), model_(b.model_),
+	  boxMin_(b.boxMin_), boxMax_(b.boxMax_) {}
 
 	const void* batch::data() {
 
@@ -32,6 +43,22 @@ namespace VoxelEng {
 
 	}
 
+	vec3 batch::boxMin() {
+
+		std::unique_lock<std::recursive_mutex> lock(mutex_);
+
+		return boxMin_;
+
+	}
+
+	vec3 batch::boxMax() {
+
+		std::unique_lock<std::recursive_mutex> lock(mutex_);
+
+		return boxMax_;
+
+	}
+
 	unsigned int batch::nEntities() {
 
 		std::unique_lock<std::recursive_mutex> lock(mutex_);
@@ -166,90 +193,76 @@ namespace VoxelEng {
 	
 	const model& batch::generateVertices() {
 
-		float sinAngleX,
-			  cosAngleX,
-			  sinAngleY,
-			  cosAngleY,
-			  sinAngleZ,
-			  cosAngleZ,
-			  oldFirstCoord,
-			  oldSecondCoord;
-		model entityModel;
-		bool updateXRot,
-			 updateYRot,
-			 updateZRot;
+		std::unique_lock<std::recursive_mutex> lock(mutex_);
 
+		// The batch's vertex data is sized beforehand so that the entities' models are transformed straight into it.
+		std::size_t nVertices = 0;
+		for (auto it = activeEntityID_.cbegin(); it != activeEntityID_.cend(); it++)
+			nVertices += entityManager::getEntity(*it).entityModel().size();
+		model_.resize(nVertices);
 
-		std::unique_lock<std::recursive_mutex> lock(mutex_);
+		boxMin_ = vec3(std::numeric_limits<float>::max());
+		boxMax_ = vec3(std::numeric_limits<float>::lowest());
 
-		model_.clear();
+		std::size_t firstVertex = 0;
 		for (auto it = activeEntityID_.cbegin(); it != activeEntityID_.cend(); it++) {
 
 			entity& selectedEntity = entityManager::getEntity(*it);
-			entityModel = selectedEntity.entityModel();
+			const model& entityModel = selectedEntity.entityModel();
 
 			if (entityModel.size()) {
-			
-				sinAngleX = selectedEntity.sinAngleX();
-				cosAngleX = selectedEntity.cosAngleX();
-				sinAngleY = selectedEntity.sinAngleY();
-				cosAngleY = selectedEntity.cosAngleY();
-				sinAngleZ = selectedEntity.sinAngleZ();
-				cosAngleZ = selectedEntity.cosAngleZ();
-				updateXRot = selectedEntity.updateXRotation();
-				updateYRot = selectedEntity.updateYRotation();
-				updateZRot = selectedEntity.updateZRotation();
 
-				// Translate the model's copy to the entity's position and apply rotations if necessary.
-				for (unsigned int j = 0; j < entityModel.size(); j++) {
+				// The rotations around the X, Y and Z axes (in that order) are composed into a single matrix.
+				float rotation[3][3] = { {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f} };
+				auto applyRotation = [&rotation](const float axisRotation[3][3]) {
 
-					// Rotate.
-					if (updateXRot) {
+					float result[3][3];
+					for (unsigned int i = 0; i < 3; i++)
+						for (unsigned int j = 0; j < 3; j++)
+							result[i][j] = axisRotation[i][0] * rotation[0][j] + axisRotation[i][1] * rotation[1][j] + axisRotation[i][2] * rotation[2][j];
+					std::copy(&result[0][0], &result[0][0] + 9, &rotation[0][0]);
 
-						oldFirstCoord = entityModel[j].positions[1];
-						oldSecondCoord = entityModel[j].positions[2];
+				};
 
-						entityModel[j].positions[1] = oldFirstCoord * cosAngleX -
-							oldSecondCoord * sinAngleX;
-						entityModel[j].positions[2] = oldFirstCoord * sinAngleX +
-							oldSecondCoord * cosAngleX;
+				if (selectedEntity.updateXRotation()) {
 
-					}
+					float sinAngle = selectedEntity.sinAngleX(),
+						  cosAngle = selectedEntity.cosAngleX();
+					const float xRotation[3][3] = { {1.0f, 0.0f, 0.0f}, {0.0f, cosAngle, -sinAngle}, {0.0f, sinAngle, cosAngle} };
+					applyRotation(xRotation);
 
-					if (updateYRot) {
+				}
 
-						oldFirstCoord = entityModel[j].positions[0];
-						oldSecondCoord = entityModel[j].positions[2];
+				if (selectedEntity.updateYRotation()) {
 
-						entityModel[j].positions[0] = oldFirstCoord * cosAngleY +
-							oldSecondCoord * sinAngleY;
-						entityModel[j].positions[2] = oldSecondCoord * cosAngleY -
-							oldFirstCoord * sinAngleY;
+					float sinAngle = selectedEntity.sinAngleY(),
+						  cosAngle = selectedEntity.cosAngleY();
+					const float yRotation[3][3] = { {cosAngle, 0.0f, sinAngle}, {0.0f, 1.0f, 0.0f}, {-sinAngle, 0.0f, cosAngle} };
+					applyRotation(yRotation);
 
-					}
+				}
 
-					if (updateZRot) {
+				if (selectedEntity.updateZRotation()) {
 
-						oldFirstCoord = entityModel[j].positions[0];
-						oldSecondCoord = entityModel[j].positions[1];
+					float sinAngle = selectedEntity.sinAngleZ(),
+						  cosAngle = selectedEntity.cosAngleZ();
+					const float zRotation[3][3] = { {cosAngle, -sinAngle, 0.0f}, {sinAngle, cosAngle, 0.0f}, {0.0f, 0.0f, 1.0f} };
+					applyRotation(zRotation);
 
-						entityModel[j].positions[0] = oldFirstCoord * cosAngleZ -
-							oldSecondCoord * sinAngleZ;
-						entityModel[j].positions[1] = oldFirstCoord * sinAngleZ +
-							oldSecondCoord * cosAngleZ;
+				}
 
-					}
+				transformVertices_(entityModel.data(), entityModel.size(), rotation, vec3(selectedEntity.x(), selectedEntity.y(), selectedEntity.z()),
+								   model_.data() + firstVertex, boxMin_, boxMax_);
+				firstVertex += entityModel.size();
 
-					// Translate.
-					entityModel[j].positions[0] += selectedEntity.x();
-					entityModel[j].positions[1] += selectedEntity.y();
-					entityModel[j].positions[2] += selectedEntity.z();
+			}
 
-					model_.push_back(entityModel[j]);
+		}
 
-				}
-			
-			}
+		if (model_.empty()) {
+
+			boxMin_ = vec3Zero;
+			boxMax_ = vec3Zero;
 
 		}
 
@@ -259,6 +272,99 @@ namespace VoxelEng {
 
 	}
 
+	void batch::transformVertices_(const vertex* source, std::size_t nVertices, const float rotation[3][3], const vec3& translation,
+								   vertex* destination, vec3& boxMin, vec3& boxMax) {
+
+		const float offset[3] = { translation.x, translation.y, translation.z };
+		float minCoords[3] = { boxMin.x, boxMin.y, boxMin.z },
+			  maxCoords[3] = { boxMax.x, boxMax.y, boxMax.z };
+		std::size_t i = 0;
+
+		#ifdef VOXELENG_BATCH_SSE
+
+			// The positions of four vertices at a time are loaded as a structure of arrays,
+			// so that each register holds the same coordinate of the four of them.
+			__m128 matrix[3][3],
+				   offsets[3],
+				   mins[3],
+				   maxs[3];
+			alignas(16) float coords[3][4];
+
+			for (unsigned int row = 0; row < 3; row++) {
+
+				for (unsigned int column = 0; column < 3; column++)
+					matrix[row][column] = _mm_set1_ps(rotation[row][column]);
+				offsets[row] = _mm_set1_ps(offset[row]);
+				mins[row] = _mm_set1_ps(minCoords[row]);
+				maxs[row] = _mm_set1_ps(maxCoords[row]);
+
+			}
+
+			for (; i + 4 <= nVertices; i += 4) {
+
+				__m128 x = _mm_setr_ps(source[i].positions[0], source[i + 1].positions[0], source[i + 2].positions[0], source[i + 3].positions[0]),
+					   y = _mm_setr_ps(source[i].positions[1], source[i + 1].positions[1], source[i + 2].positions[1], source[i + 3].positions[1]),
+					   z = _mm_setr_ps(source[i].positions[2], source[i + 1].positions[2], source[i + 2].positions[2], source[i + 3].positions[2]);
+
+				for (unsigned int row = 0; row < 3; row++) {
+
+					__m128 coord = _mm_add_ps(_mm_add_ps(_mm_mul_ps(matrix[row][0], x), _mm_mul_ps(matrix[row][1], y)),
+											  _mm_add_ps(_mm_mul_ps(matrix[row][2], z), offsets[row]));
+					mins[row] = _mm_min_ps(mins[row], coord);
+					maxs[row] = _mm_max_ps(maxs[row], coord);
+					_mm_store_ps(coords[row], coord);
+
+				}
+
+				// Each destination vertex is written once. Texture coordinates and normals are not transformed.
+				for (unsigned int j = 0; j < 4; j++) {
+
+					vertex& transformed = destination[i + j];
+					transformed.positions[0] = coords[0][j];
+					transformed.positions[1] = coords[1][j];
+					transformed.positions[2] = coords[2][j];
+					transformed.textureCoords[0] = source[i + j].textureCoords[0];
+					transformed.textureCoords[1] = source[i + j].textureCoords[1];
+					transformed.normals = source[i + j].normals;
+
+				}
+
+			}
+
+			for (unsigned int row = 0; row < 3; row++) {
+
+				_mm_store_ps(coords[0], mins[row]);
+				minCoords[row] = std::min(std::min(coords[0][0], coords[0][1]), std::min(coords[0][2], coords[0][3]));
+				_mm_store_ps(coords[0], maxs[row]);
+				maxCoords[row] = std::max(std::max(coords[0][0], coords[0][1]), std::max(coords[0][2], coords[0][3]));
+
+			}
+
+		#endif
+
+		// Remaining vertices (or all of them if SIMD instructions are not available).
+		for (; i < nVertices; i++) {
+
+			const vertexCoord* position = source[i].positions;
+			for (unsigned int row = 0; row < 3; row++) {
+
+				float coord = rotation[row][0] * position[0] + rotation[row][1] * position[1] + rotation[row][2] * position[2] + offset[row];
+				destination[i].positions[row] = coord;
+				minCoords[row] = std::min(minCoords[row], coord);
+				maxCoords[row] = std::max(maxCoords[row], coord);
+
+			}
+			destination[i].textureCoords[0] = source[i].textureCoords[0];
+			destination[i].textureCoords[1] = source[i].textureCoords[1];
+			destination[i].normals = source[i].normals;
+
+		}
+
+		boxMin = vec3(minCoords[0], minCoords[1], minCoords[2]);
+		boxMax = vec3(maxCoords[0], maxCoords[1], maxCoords[2]);
+
+	}
+
 	void batch::clear() {
 	
 		std::unique_lock<std::recursive_mutex> lock(mutex_);
@@ -41,6 +41,17 @@ namespace VoxelEng {
 	//Classes.//
 	////////////
 
+	/**
+	* @brief Data needed by the rendering thread to draw a batch.
+	*/
+	struct batchRenderingData {
+
+		model vertices;
+		vec3 boxMin, // Corners of the axis-aligned bounding box of the vertices.
+			 boxMax;
+
+	};
+
 	/**
 	* @brief Collection of vertex data from the models of many entities.
 	* All the models which have their vertices in the same batch will be rendered
@@ -98,6 +109,20 @@ namespace VoxelEng {
 		*/
 		bool isEntityInBatch(entityID entityID);
 
+		/**
+		* @brief Get the corner with the lowest coordinates of the axis-aligned bounding box
+		* of the vertices generated in the last call to batch::generateVertices.
+		* Thread-safe operation.
+		*/
+		vec3 boxMin();
+
+		/**
+		* @brief Get the corner with the highest coordinates of the axis-aligned bounding box
+		* of the vertices generated in the last call to batch::generateVertices.
+		* Thread-safe operation.
+		*/
+		vec3 boxMax();
+
 
 		// Modifiers.
 
@@ -155,7 +180,9 @@ namespace VoxelEng {
 		/**
 		* @brief Generates new vertices based on the entities that are in the batch and
 		* their positions/rotations/states...
-		* Sets the batch as not dirty.
+		* Sets the batch as not dirty and updates its bounding box.
+		* Each entity's model is transformed into the batch's own vertex data (its model), four vertices at a time with SIMD instructions where available.
+		* The entities' models are only read.
 		* WARNING. It overwrites any other vertex data stored inside the batch.
 		*/
 		const model& generateVertices();
@@ -174,6 +201,21 @@ namespace VoxelEng {
 		std::unordered_set<unsigned int> activeEntityID_,
 										 inactiveEntityID_;
 		model model_;
+		vec3 boxMin_,
+			 boxMax_;
+
+
+		/*
+		Methods.
+		*/
+
+		/*
+		Writes into 'destination' the 'nVertices' vertices of 'source' with their positions rotated by
+		the row-major matrix 'rotation' and then translated by 'translation'. The rest of their data is copied as is.
+		Updates 'boxMin' and 'boxMax' to also contain the transformed positions.
+		*/
+		static void transformVertices_(const vertex* source, std::size_t nVertices, const float rotation[3][3], const vec3& translation,
+									   vertex* destination, vec3& boxMin, vec3& boxMax);
 
 		
 
@@ -0,0 +1,259 @@
+/**
+* @file chunkLayoutBenchmark.cpp
+* @version 1.0
+* @date 17/10/2026
+* @author Abdon Crespo Alvarez
+* @title Chunk layout benchmark.
+* @brief Compares the row-major (Z fastest) and Morton (Z-order) layouts of chunk blocks
+* with the access patterns of the engine that depend on it: copying a chunk's blocks for
+* meshing (chunk::copyPaddedBlocks_), Y-major column scans during world generation
+* (miningWorldGen::generate_) and box reads that cross chunks (AI vision through
+* chunkManager::getBlocksBox). Blocks are bit-packed in 64-bit words like chunk block data.
+* Since CHUNK_MORTON_LAYOUT is a compile-time constant, this benchmark reimplements both
+* index functions with the same formulas as chunk::linearIndex_, so it does not depend on
+* the rest of the engine and both layouts are measured by the same executable.
+*/
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+	//////////////
+	//Constants.//
+	//////////////
+
+	const unsigned int CHUNK_SIZE = 16,
+					   N_CHUNK_BLOCKS = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE,
+					   PADDED_SIZE = CHUNK_SIZE + 2;
+
+	/*
+	The benchmark world has WORLD_X * WORLD_Y * WORLD_Z chunks.
+	*/
+	const unsigned int WORLD_X = 16,
+					   WORLD_Y = 8,
+					   WORLD_Z = 16,
+					   N_CHUNKS = WORLD_X * WORLD_Y * WORLD_Z;
+
+	const unsigned int N_REPETITIONS = 20;
+	const unsigned int N_VISION_BOXES = 200000,
+					   VISION_BOX_SIZE = 9;
+
+
+	////////////
+	//Classes.//
+	////////////
+
+	enum class blockLayout { ROW_MAJOR = 0, MORTON = 1 };
+
+	/*
+	Blocks of all chunks of the benchmark world, stored as 'bitsPerBlock' bit-packed
+	palette indices in the order given by 'layout'.
+	*/
+	template <blockLayout layout>
+	class world {
+
+	public:
+
+		world(unsigned int bitsPerBlock)
+		: bitsPerBlock_(bitsPerBlock),
+		  mask_((1ull << bitsPerBlock) - 1),
+		  words_(N_CHUNKS * (N_CHUNK_BLOCKS * bitsPerBlock / 64), 0) {}
+
+		static unsigned int linearIndex(unsigned int x, unsigned int y, unsigned int z) {
+
+			if constexpr (layout == blockLayout::MORTON)
+				return (spreadBits_(x) << 2) | (spreadBits_(y) << 1) | spreadBits_(z);
+			else
+				return x * CHUNK_SIZE * CHUNK_SIZE + y * CHUNK_SIZE + z;
+
+		}
+
+		std::uint64_t get(unsigned int chunk, unsigned int linearIndex) const {
+
+			std::size_t bit = (std::size_t)chunk * N_CHUNK_BLOCKS * bitsPerBlock_ + (std::size_t)linearIndex * bitsPerBlock_;
+
+			return (words_[bit >> 6] >> (bit & 63)) & mask_;
+
+		}
+
+		void set(unsigned int chunk, unsigned int linearIndex, std::uint64_t value) {
+
+			std::size_t bit = (std::size_t)chunk * N_CHUNK_BLOCKS * bitsPerBlock_ + (std::size_t)linearIndex * bitsPerBlock_;
+			std::uint64_t& word = words_[bit >> 6];
+
+			word = (word & ~(mask_ << (bit & 63))) | (value << (bit & 63));
+
+		}
+
+	private:
+
+		unsigned int bitsPerBlock_;
+		std::uint64_t mask_;
+		std::vector<std::uint64_t> words_;
+
+		static unsigned int spreadBits_(unsigned int value) {
+
+			value = (value | (value << 4)) & 0xC3u;
+			return (value | (value << 2)) & 0x249u;
+
+		}
+
+	};
+
+
+	/////////////////////////
+	//Function definitions.//
+	/////////////////////////
+
+	double elapsedMs(std::chrono::high_resolution_clock::time_point start) {
+
+		return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	}
+
+	/*
+	Y-major column scans that fill the empty blocks below a terrain height, as world generation does.
+	*/
+	template <blockLayout layout>
+	double generation(world<layout>& blocks, std::uint64_t& checksum) {
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		for (unsigned int repetition = 0; repetition < N_REPETITIONS; repetition++)
+			for (unsigned int chunk = 0; chunk < N_CHUNKS; chunk++)
+				for (unsigned int x = 0; x < CHUNK_SIZE; x++)
+					for (unsigned int z = 0; z < CHUNK_SIZE; z++)
+						for (unsigned int y = 0; y < CHUNK_SIZE; y++) {
+
+							unsigned int linearIndex = world<layout>::linearIndex(x, y, z);
+							if (!blocks.get(chunk, linearIndex) || repetition)
+								blocks.set(chunk, linearIndex, (y + (chunk / WORLD_Z) % WORLD_Y * CHUNK_SIZE < (x ^ z) + 40) ? 1 + (x + y + z + repetition) % 3 : 0);
+
+						}
+
+		for (unsigned int chunk = 0; chunk < N_CHUNKS; chunk++)
+			checksum += blocks.get(chunk, world<layout>::linearIndex(chunk % CHUNK_SIZE, (chunk / CHUNK_SIZE) % CHUNK_SIZE, 0));
+
+		return elapsedMs(start) / N_REPETITIONS;
+
+	}
+
+	/*
+	Copies of each chunk's blocks into a padded buffer in X, Y, Z order, as done before meshing a chunk.
+	*/
+	template <blockLayout layout>
+	double meshingCopy(const world<layout>& blocks, std::uint64_t& checksum) {
+
+		std::vector<std::uint16_t> paddedBlocks(PADDED_SIZE * PADDED_SIZE * PADDED_SIZE);
+		auto start = std::chrono::high_resolution_clock::now();
+
+		for (unsigned int repetition = 0; repetition < N_REPETITIONS; repetition++)
+			for (unsigned int chunk = 0; chunk < N_CHUNKS; chunk++) {
+
+				for (unsigned int x = 0; x < CHUNK_SIZE; x++)
+					for (unsigned int y = 0; y < CHUNK_SIZE; y++)
+						for (unsigned int z = 0; z < CHUNK_SIZE; z++)
+							paddedBlocks[((x + 1) * PADDED_SIZE + y + 1) * PADDED_SIZE + z + 1] = (std::uint16_t)blocks.get(chunk, world<layout>::linearIndex(x, y, z));
+
+				checksum += paddedBlocks[(chunk % PADDED_SIZE) * PADDED_SIZE * PADDED_SIZE + PADDED_SIZE + 1];
+
+			}
+
+		return elapsedMs(start) / N_REPETITIONS;
+
+	}
+
+	/*
+	Reads of cubic boxes of blocks at random positions of the world, crossing chunk borders,
+	in the X, Y, Z order used by chunkManager::getBlocksBox.
+	*/
+	template <blockLayout layout>
+	double visionBoxes(const world<layout>& blocks, std::uint64_t& checksum) {
+
+		std::mt19937 generator(3);
+		std::uniform_int_distribution<unsigned int> posX(0, WORLD_X * CHUNK_SIZE - VISION_BOX_SIZE),
+													posY(0, WORLD_Y * CHUNK_SIZE - VISION_BOX_SIZE),
+													posZ(0, WORLD_Z * CHUNK_SIZE - VISION_BOX_SIZE);
+		std::vector<unsigned int> boxes(N_VISION_BOXES * 3);
+		for (unsigned int i = 0; i < N_VISION_BOXES; i++) {
+
+			boxes[i * 3] = posX(generator);
+			boxes[i * 3 + 1] = posY(generator);
+			boxes[i * 3 + 2] = posZ(generator);
+
+		}
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		for (unsigned int box = 0; box < N_VISION_BOXES; box++)
+			for (unsigned int i = boxes[box * 3]; i < boxes[box * 3] + VISION_BOX_SIZE; i++)
+				for (unsigned int j = boxes[box * 3 + 1]; j < boxes[box * 3 + 1] + VISION_BOX_SIZE; j++)
+					for (unsigned int k = boxes[box * 3 + 2]; k < boxes[box * 3 + 2] + VISION_BOX_SIZE; k++) {
+
+						unsigned int chunk = ((i / CHUNK_SIZE) * WORLD_Y + j / CHUNK_SIZE) * WORLD_Z + k / CHUNK_SIZE;
+						checksum += blocks.get(chunk, world<layout>::linearIndex(i % CHUNK_SIZE, j % CHUNK_SIZE, k % CHUNK_SIZE));
+
+					}
+
+		return elapsedMs(start);
+
+	}
+
+	/*
+	Runs the three access patterns over a world with the specified layout and bits per block.
+	*/
+	template <blockLayout layout>
+	void run(unsigned int bitsPerBlock, double times[3], std::uint64_t& checksum) {
+
+		world<layout> blocks(bitsPerBlock);
+
+		times[0] = generation(blocks, checksum);
+		times[1] = meshingCopy(blocks, checksum);
+		times[2] = visionBoxes(blocks, checksum);
+
+	}
+
+}
+
+
+int main() {
+
+	const unsigned int bitsPerBlock[2] = { 4, 16 };
+	const char* patterns[3] = { "generation (ms per world)", "meshing copy (ms per world)", "vision boxes (ms)" };
+	std::uint64_t rowMajorChecksum = 0,
+				  mortonChecksum = 0;
+
+	std::cout << "world: " << WORLD_X << "x" << WORLD_Y << "x" << WORLD_Z << " chunks, "
+			  << N_VISION_BOXES << " vision boxes of " << VISION_BOX_SIZE << "^3 blocks" << std::endl;
+	std::cout << "bits per block | pattern | row-major | Morton | Morton speedup" << std::endl;
+
+	for (unsigned int bits : bitsPerBlock) {
+
+		double rowMajor[3],
+			   morton[3];
+
+		run<blockLayout::ROW_MAJOR>(bits, rowMajor, rowMajorChecksum);
+		run<blockLayout::MORTON>(bits, morton, mortonChecksum);
+
+		for (unsigned int pattern = 0; pattern < 3; pattern++)
+			std::cout << bits << " | " << patterns[pattern] << " | " << rowMajor[pattern] << " | "
+					  << morton[pattern] << " | " << rowMajor[pattern] / morton[pattern] << std::endl;
+
+	}
+
+	// Both layouts store the same blocks, so they must read the same values.
+	if (rowMajorChecksum != mortonChecksum) {
+
+		std::cout << "Checksum mismatch between layouts" << std::endl;
+		return 1;
+
+	}
+
+	return 0;
+
+}
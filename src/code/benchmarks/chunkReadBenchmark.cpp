@@ -0,0 +1,139 @@
+/**
+* @file chunkReadBenchmark.cpp
+* @version 1.0
+* @date 17/10/2026
+* @author Abdon Crespo Alvarez
+* @title Chunk read benchmark.
+* @brief Measures how the throughput of chunk::getBlock scales with the number of threads
+* reading the same chunk, compared with reads that lock the chunk's block data mutex in
+* exclusive mode (as every read did before lock-free reads were introduced).
+* A writer thread keeps editing the chunk during the second half of the runs.
+*/
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../chunk.h"
+#include "../timer.h"
+
+
+namespace {
+
+	//////////////
+	//Constants.//
+	//////////////
+
+	const unsigned int READS_PER_THREAD = 4000000;
+	const unsigned int MAX_READER_THREADS = 16;
+
+
+	/////////////////////////
+	//Function definitions.//
+	/////////////////////////
+
+	/*
+	Reads READS_PER_THREAD blocks from 'selectedChunk' with each of 'nThreads' threads
+	and returns the number of blocks read per second by all of them.
+	If 'lockedReads' is true, each read locks the chunk's block data mutex in exclusive mode.
+	If 'withWriter' is true, another thread keeps editing the chunk while the blocks are read.
+	*/
+	double readThroughput(VoxelEng::chunk& selectedChunk, unsigned int nThreads, bool lockedReads, bool withWriter) {
+
+		std::vector<std::thread> readers;
+		std::atomic<bool> stopWriter = false;
+		std::atomic<unsigned long long> checksum = 0;
+		std::thread writer;
+		VoxelEng::timer t;
+
+		if (withWriter)
+			writer = std::thread([&selectedChunk, &stopWriter]() {
+
+				std::mt19937 generator(7);
+				std::uniform_int_distribution<unsigned int> index(0, VoxelEng::N_CHUNK_BLOCKS - 1);
+				std::uniform_int_distribution<unsigned int> blockID(1, 12);
+
+				while (!stopWriter)
+					selectedChunk.setBlock(index(generator), blockID(generator));
+
+			});
+
+		t.start();
+
+		for (unsigned int i = 0; i < nThreads; i++)
+			readers.push_back(std::thread([&selectedChunk, &checksum, lockedReads, i]() {
+
+				unsigned long long sum = 0;
+				unsigned int linearIndex = i * 977;
+
+				for (unsigned int j = 0; j < READS_PER_THREAD; j++) {
+
+					linearIndex = (linearIndex + 2053) % VoxelEng::N_CHUNK_BLOCKS;
+
+					if (lockedReads) {
+
+						std::unique_lock<std::shared_mutex> lock(selectedChunk.blockDataMutex());
+						sum += selectedChunk.getBlockLinear(linearIndex);
+
+					}
+					else
+						sum += selectedChunk.getBlockLinear(linearIndex);
+
+				}
+
+				checksum += sum;
+
+			}));
+
+		for (std::thread& reader : readers)
+			reader.join();
+
+		t.finish();
+
+		if (withWriter) {
+
+			stopWriter = true;
+			writer.join();
+
+		}
+
+		double seconds = std::max<double>(t.getDurationMs(), 1) / 1000.0;
+
+		return (double)nThreads * READS_PER_THREAD / seconds;
+
+	}
+
+}
+
+
+int main() {
+
+	VoxelEng::chunk selectedChunk(true);
+	std::mt19937 generator(1);
+	std::uniform_int_distribution<unsigned int> blockID(0, 12);
+
+	for (unsigned int i = 0; i < VoxelEng::N_CHUNK_BLOCKS; i++)
+		selectedChunk.setBlock(i, blockID(generator));
+
+	std::cout << "threads | writer | exclusive lock (Mreads/s) | lock-free (Mreads/s) | speedup" << std::endl;
+
+	for (int withWriter = 0; withWriter < 2; withWriter++)
+		for (unsigned int nThreads = 1; nThreads <= MAX_READER_THREADS; nThreads *= 2) {
+
+			double locked = readThroughput(selectedChunk, nThreads, true, withWriter),
+				   lockFree = readThroughput(selectedChunk, nThreads, false, withWriter);
+
+			std::cout << nThreads << " | " << (withWriter ? "yes" : "no") << " | " << locked / 1e6 << " | "
+					  << lockFree / 1e6 << " | " << lockFree / locked << std::endl;
+
+		}
+
+	VoxelEng::chunkReclaimer::cleanUp();
+
+	return 0;
+
+}
@@ -0,0 +1,170 @@
+/**
+* @file chunkRegistryBenchmark.cpp
+* @version 1.0
+* @date 17/10/2026
+* @author Abdon Crespo Alvarez
+* @title Chunk registry contention benchmark.
+* @brief Measures the throughput of chunkManager::getBlock with N reader threads while two
+* other threads keep creating and unloading chunks, racing to register the same positions.
+* It is compared with the same workload serialised on a single recursive mutex, as the chunk
+* management system did before the chunk registry became a reader-writer locked grid.
+*/
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../chunk.h"
+#include "../timer.h"
+
+
+namespace {
+
+	//////////////
+	//Constants.//
+	//////////////
+
+	const unsigned int READS_PER_THREAD = 2000000;
+	const unsigned int MAX_READER_THREADS = 16;
+
+	/*
+	Readers only read the chunks in [-READ_RANGE, READ_RANGE) along X and Z at chunk height 0,
+	which are never unloaded. The churning threads create and unload the chunks in
+	[CHURN_START, CHURN_START + CHURN_RANGE) along X instead.
+	*/
+	const int READ_RANGE = 2;
+	const int CHURN_START = 4,
+			  CHURN_RANGE = 4;
+
+
+	//////////////
+	//Variables.//
+	//////////////
+
+	std::recursive_mutex globalChunksMutex;
+
+
+	/////////////////////////
+	//Function definitions.//
+	/////////////////////////
+
+	/*
+	Reads READS_PER_THREAD blocks with each of 'nThreads' threads while the chunks out of the
+	read range are created and unloaded by two other threads. Returns the number of blocks read per second.
+	If 'globalLock' is true, every read, creation and unload locks the same recursive mutex.
+	*/
+	double readThroughput(unsigned int nThreads, bool globalLock) {
+
+		std::vector<std::thread> readers,
+								 churners;
+		std::atomic<bool> stopChurn = false;
+		std::atomic<unsigned long long> checksum = 0;
+		VoxelEng::timer t;
+
+		for (unsigned int i = 0; i < 2; i++)
+			churners.push_back(std::thread([&stopChurn, globalLock]() {
+
+				std::unique_lock<std::recursive_mutex> lock(globalChunksMutex, std::defer_lock);
+				VoxelEng::vec3 chunkPos;
+
+				while (!stopChurn)
+					for (int x = CHURN_START; x < CHURN_START + CHURN_RANGE; x++) {
+
+						chunkPos = VoxelEng::vec3(x, 0, 0);
+
+						if (globalLock)
+							lock.lock();
+
+						// Both threads race to create and unload the same positions.
+						VoxelEng::chunkManager::createChunk(true, chunkPos);
+						VoxelEng::chunkManager::unloadChunk(chunkPos);
+
+						if (globalLock)
+							lock.unlock();
+
+					}
+
+			}));
+
+		t.start();
+
+		for (unsigned int i = 0; i < nThreads; i++)
+			readers.push_back(std::thread([&checksum, globalLock, i]() {
+
+				unsigned long long sum = 0;
+				unsigned int n = i * 7919;
+				int x = 0,
+					z = 0;
+
+				for (unsigned int j = 0; j < READS_PER_THREAD; j++) {
+
+					n = n * 1664525 + 1013904223;
+					x = (int)(n % (2 * READ_RANGE * VoxelEng::SCX)) - READ_RANGE * VoxelEng::SCX;
+					z = (int)((n >> 16) % (2 * READ_RANGE * VoxelEng::SCZ)) - READ_RANGE * VoxelEng::SCZ;
+
+					if (globalLock) {
+
+						std::unique_lock<std::recursive_mutex> lock(globalChunksMutex);
+						sum += VoxelEng::chunkManager::getBlock(x, (int)(n % VoxelEng::SCY), z);
+
+					}
+					else
+						sum += VoxelEng::chunkManager::getBlock(x, (int)(n % VoxelEng::SCY), z);
+
+				}
+
+				checksum += sum;
+
+			}));
+
+		for (std::thread& reader : readers)
+			reader.join();
+
+		t.finish();
+
+		stopChurn = true;
+		for (std::thread& churner : churners)
+			churner.join();
+
+		double seconds = std::max<double>(t.getDurationMs(), 1) / 1000.0;
+
+		return (double)nThreads * READS_PER_THREAD / seconds;
+
+	}
+
+}
+
+
+int main() {
+
+	VoxelEng::chunkManager::init(CHURN_START + CHURN_RANGE);
+
+	for (int x = -READ_RANGE; x < READ_RANGE; x++)
+		for (int z = -READ_RANGE; z < READ_RANGE; z++) {
+
+			VoxelEng::chunk* selectedChunk = VoxelEng::chunkManager::createChunk(true, VoxelEng::vec3(x, 0, z));
+			for (unsigned int i = 0; i < VoxelEng::N_CHUNK_BLOCKS; i += 3)
+				selectedChunk->setBlock(i, (i % 11) + 1);
+
+		}
+
+	std::cout << "threads | global recursive mutex (Mreads/s) | chunk registry (Mreads/s) | speedup" << std::endl;
+
+	for (unsigned int nThreads = 1; nThreads <= MAX_READER_THREADS; nThreads *= 2) {
+
+		double locked = readThroughput(nThreads, true),
+			   registry = readThroughput(nThreads, false);
+
+		std::cout << nThreads << " | " << locked / 1e6 << " | " << registry / 1e6 << " | " << registry / locked << std::endl;
+
+	}
+
+	std::cout << "Chunks left acquired from the pool: " << VoxelEng::chunkPool::nAcquiredChunks()
+			  << " (expected " << 4 * READ_RANGE * READ_RANGE << ")" << std::endl;
+
+	VoxelEng::chunkManager::cleanUp();
+
+	return 0;
+
+}
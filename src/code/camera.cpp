@@ -4,6 +4,33 @@
 
 namespace VoxelEng {
 
+    // 'frustum' class.
+
+    frustum::frustum() {
+
+        for (unsigned int i = 0; i < 6; i++)
+            planes_[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+    }
+
+    void frustum::update(const glm::mat4& viewProjection) {
+
+        // Gribb-Hartmann extraction. Each plane is the sum or difference of the matrix's last row and one of the others.
+        // glm matrices are stored by columns, so viewProjection[j][i] is the element of the i-th row and j-th column.
+        glm::vec4 rows[4];
+        for (unsigned int i = 0; i < 4; i++)
+            rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+
+        planes_[0] = rows[3] + rows[0]; // Left.
+        planes_[1] = rows[3] - rows[0]; // Right.
+        planes_[2] = rows[3] + rows[1]; // Bottom.
+        planes_[3] = rows[3] - rows[1]; // Top.
+        planes_[4] = rows[3] + rows[2]; // Near.
+        planes_[5] = rows[3] - rows[2]; // Far.
+
+    }
+
+
     // 'camera' class.
 
     camera* camera::playerCamera_ = nullptr;
@@ -66,6 +93,7 @@ namespace VoxelEng {
         #if GRAPHICS_API == OPENGL
 
             projectionMatrix_ = glm::perspective(glm::radians(FOV_), static_cast<float>(window_.width()) / window_.height(), zNear_, zFar_);
+            viewFrustum_.update(projectionMatrix_ * viewMatrix_);
 
         #else
 
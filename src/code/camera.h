@@ -40,6 +40,58 @@ namespace VoxelEng {
 	//Classes.//
 	////////////
 
+	/**
+	* @brief View frustum of a camera, represented by its six planes
+	* with their normals pointing towards the inside of the frustum.
+	*/
+	class frustum {
+
+	public:
+
+		// Constructors.
+
+		/**
+		* @brief Default constructor. The frustum contains the whole space.
+		*/
+		frustum();
+
+
+		// Observers.
+
+		/**
+		* @brief Returns true if the axis-aligned box between the corners 'min' and 'max' is,
+		* at least partially, inside the frustum or false otherwise.
+		* Boxes near the frustum's edges may be reported as inside although they are not.
+		*/
+		bool intersects(const vec3& min, const vec3& max) const;
+
+
+		// Modifiers.
+
+		/**
+		* @brief Extracts the frustum's planes from a projection matrix multiplied by a view matrix.
+		*/
+		void update(const glm::mat4& viewProjection);
+
+	private:
+
+		glm::vec4 planes_[6]; // Left, right, bottom, top, near and far planes as (a, b, c, d) with ax + by + cz + d = 0.
+
+	};
+
+	inline bool frustum::intersects(const vec3& min, const vec3& max) const {
+
+		// The box is outside if its corner furthest along a plane's normal is behind that plane.
+		for (unsigned int i = 0; i < 6; i++)
+			if (planes_[i].x * (planes_[i].x >= 0.0f ? max.x : min.x) +
+				planes_[i].y * (planes_[i].y >= 0.0f ? max.y : min.y) +
+				planes_[i].z * (planes_[i].z >= 0.0f ? max.z : min.z) + planes_[i].w < 0.0f)
+				return false;
+
+		return true;
+
+	}
+
 	/**
 	* @brief Abstraction of an object capable of "viewing" a portion
 	* of a simulated 3D world and provide several utilities to
@@ -118,6 +170,12 @@ namespace VoxelEng {
 		*/
 		const vec3& pos() const;
 
+		/**
+		* @brief Get the camera's view frustum in world coordinates.
+		* It is updated with every call to camera::updateView() or camera::updateProjectionMatrix().
+		*/
+		const frustum& viewFrustum() const;
+
 
 		// Modifiers.
 
@@ -285,6 +343,8 @@ namespace VoxelEng {
 			 chunkPosition_,
 			 oldChunkPos_;
 
+		frustum viewFrustum_;
+
 	};
 
 	inline const camera* camera::cPlayerCamera() {
@@ -353,6 +413,12 @@ namespace VoxelEng {
 
 	}
 
+	inline const frustum& camera::viewFrustum() const {
+
+		return viewFrustum_;
+
+	}
+
 	inline camera* camera::playerCamera() {
 
 		return playerCamera_;
@@ -448,6 +514,7 @@ namespace VoxelEng {
 		#if GRAPHICS_API == OPENGL
 
 			viewMatrix_ = glm::lookAt(position_, position_ + direction_, upAxis_);
+			viewFrustum_.update(projectionMatrix_ * viewMatrix_);
 
 		#else
 
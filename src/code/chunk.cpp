@@ -8,10 +8,16 @@
 #include <cstdlib>
 #include <cmath>
 #include <cstddef>
+#include <algorithm>
+#include <bit>
+#include <bitset>
+#include <limits>
+#include <optional>
 #include "input.h"
 #include "gui.h"
 #include "logger.h"
 #include "timer.h"
+#include "taskScheduler.h"
 #include "aiAPI.h"
 #include "game.h"
 #include "entity.h"
@@ -27,15 +33,150 @@ namespace VoxelEng {
     class game;
 
 
+    //////////////
+    //Constants.//
+    //////////////
+
+    /*
+    Block faces in the order used by the meshers: front (Z+), back (Z-), top (Y+), bottom (Y-),
+    right (X+) and left (X-). For each face, the axis its normal lies on, whether its normal points
+    towards the positive side of said axis and its triangles in the block model.
+    */
+    const unsigned int MESH_FACE_AXIS[6] = { 2, 2, 1, 1, 0, 0 };
+    const bool MESH_FACE_POSITIVE[6] = { true, false, true, false, true, false };
+    const unsigned int MESH_FACE_TRIANGLES[6] = { 1, 0, 2, 3, 5, 4 };
+
+    /*
+    Block ID that meshers use for the blocks of missing neighbor chunks.
+    Any non-null ID works since only whether a block is solid matters for them.
+    */
+    const block MESH_MISSING_NEIGHBOR_BLOCK = std::numeric_limits<block>::max();
+
+
     ////////////
     //Classes.//
     ////////////
 
+    // 'chunkReclaimer' class.
+
+    std::atomic<std::uint64_t> chunkReclaimer::epoch_ = 1;
+    chunkReclaimer::readerEpoch chunkReclaimer::readerEpochs_[CHUNK_MAX_READER_THREADS];
+    std::atomic<bool> chunkReclaimer::readerSlotsUsed_[CHUNK_MAX_READER_THREADS];
+    thread_local chunkReclaimer::readerState chunkReclaimer::reader_;
+    std::deque<chunkReclaimer::retiredStorage> chunkReclaimer::retired_;
+    std::mutex chunkReclaimer::retiredMutex_;
+
+
+    chunkReclaimer::readerState::~readerState() {
+
+        if (slot != -1) {
+
+            readerEpochs_[slot].epoch.store(0);
+            readerSlotsUsed_[slot].store(false, std::memory_order_release);
+
+        }
+
+    }
+
+    bool chunkReclaimer::isSafe(std::uint64_t epoch) {
+
+        return epoch < oldestActiveEpoch_();
+
+    }
+
+    std::size_t chunkReclaimer::nRetired() {
+
+        std::unique_lock<std::mutex> lock(retiredMutex_);
+
+        return retired_.size();
+
+    }
+
+    void chunkReclaimer::retire(std::vector<std::vector<block>>&& palettes, std::vector<std::vector<std::uint64_t>>&& blockWords,
+                                const chunkBlockStorageView* view) {
+
+        if (palettes.empty() && blockWords.empty() && !view)
+            return;
+
+        std::uint64_t epoch = retireEpoch();
+
+        std::unique_lock<std::mutex> lock(retiredMutex_);
+
+        retired_.push_back({ epoch, std::move(palettes), std::move(blockWords), std::unique_ptr<const chunkBlockStorageView>(view) });
+
+        // Retired memory is also freed here so that it does not pile up when chunks are edited
+        // without the chunk management thread running (for example, with finite worlds).
+        if (retired_.size() >= CHUNK_RECLAIM_THRESHOLD)
+            reclaim_();
+
+    }
+
+    void chunkReclaimer::reclaim() {
+
+        std::unique_lock<std::mutex> lock(retiredMutex_);
+
+        reclaim_();
+
+    }
+
+    void chunkReclaimer::cleanUp() {
+
+        std::unique_lock<std::mutex> lock(retiredMutex_);
+
+        retired_.clear();
+
+    }
+
+    int chunkReclaimer::claimReaderSlot_() {
+
+        bool used = false;
+        for (unsigned int i = 0; i < CHUNK_MAX_READER_THREADS; i++) {
+
+            used = false;
+            if (readerSlotsUsed_[i].compare_exchange_strong(used, true))
+                return i;
+
+        }
+
+        logger::errorLog("More than " + std::to_string(CHUNK_MAX_READER_THREADS) + " threads are reading chunks at the same time");
+
+    }
+
+    std::uint64_t chunkReclaimer::oldestActiveEpoch_() {
+
+        std::uint64_t oldestEpoch = std::numeric_limits<std::uint64_t>::max(),
+                      epoch = 0;
+        for (unsigned int i = 0; i < CHUNK_MAX_READER_THREADS; i++)
+            if ((epoch = readerEpochs_[i].epoch.load()) && epoch < oldestEpoch)
+                oldestEpoch = epoch;
+
+        return oldestEpoch;
+
+    }
+
+    void chunkReclaimer::reclaim_() {
+
+        // Memory is retired in roughly increasing epoch order. Any memory left behind
+        // an unsafe entry is freed by a later call.
+        std::uint64_t oldestEpoch = oldestActiveEpoch_();
+        while (!retired_.empty() && retired_.front().epoch < oldestEpoch)
+            retired_.pop_front();
+
+    }
+
+
     // 'chunk' class.
 
     bool chunk::initialised_ = false;
     const model* chunk::blockVertices_ = nullptr;
     const modelTriangles* chunk::blockTriangles_ = nullptr;
+    std::atomic<chunkMeshingMode> chunk::meshingMode_ = chunkMeshingMode::NAIVE;
+    thread_local block chunk::paddedBlocks_[CHUNK_PADDED_VOLUME];
+    thread_local block chunk::lodBlocks_[CHUNK_PADDED_VOLUME];
+    thread_local std::uint16_t chunk::floodFillStack_[N_CHUNK_BLOCKS];
+    chunk::faceTemplate chunk::faceTemplates_[6];
+    std::atomic<std::uint64_t> chunk::nMeshesBuilt_ = 0;
+    std::atomic<unsigned int> chunk::nSpareMeshes_ = 0;
 
 
     void chunk::init() {
@@ -47,6 +188,50 @@ namespace VoxelEng {
             blockVertices_ = &models::getModelAt(1);
             blockTriangles_ = &models::getModelTriangles(1);
 
+            // Precompute the block faces used by the meshers. Each face is made of the 4 distinct corners of
+            // the block model's face triangles, which the chunk quad index buffer (0, 1, 2, 2, 1, 3) shares
+            // between the two triangles. The texture is placed in the same way as models::addTexture does,
+            // so its horizontal axis runs between the face's first and third corners and the vertical one
+            // between the first and second corners.
+            const unsigned int faceCorners[CHUNK_VERTICES_PER_FACE] = { 0, 1, 2, 5 },
+                               textureCorners[CHUNK_VERTICES_PER_FACE] = { 0, 2, 1, 3 };
+            for (unsigned int face = 0; face < 6; face++) {
+
+                const triangle& triangles = blockTriangles_->operator[](MESH_FACE_TRIANGLES[face]);
+                const vertex& first = blockVertices_->operator[](triangles[0]),
+                            & second = blockVertices_->operator[](triangles[1]),
+                            & third = blockVertices_->operator[](triangles[2]);
+                faceTemplate& faceTemplate = faceTemplates_[face];
+
+                for (unsigned int axis = 0; axis < 3; axis++) {
+
+                    if (third.positions[axis] != first.positions[axis])
+                        faceTemplate.textureAxes[0] = axis;
+
+                    if (second.positions[axis] != first.positions[axis])
+                        faceTemplate.textureAxes[1] = axis;
+
+                }
+
+                for (unsigned int corner = 0; corner < CHUNK_VERTICES_PER_FACE; corner++) {
+
+                    const vertex& blockVertex = blockVertices_->operator[](triangles[faceCorners[corner]]);
+
+                    faceTemplate.corners[corner] = 0;
+                    faceTemplate.textureCorners[corner] = textureCorners[corner];
+                    faceTemplate.vertices[corner] = (face << 15) | ((textureCorners[corner] & 1) << 18) | ((textureCorners[corner] >> 1) << 23);
+                    for (unsigned int axis = 0; axis < 3; axis++)
+                        if (blockVertex.positions[axis]) {
+
+                            faceTemplate.corners[corner] |= 1 << axis;
+                            faceTemplate.vertices[corner] |= 1 << (5 * axis);
+
+                        }
+
+                }
+
+            }
+
             initialised_ = true;
         
         }
@@ -54,52 +239,74 @@ namespace VoxelEng {
     }
 
     chunk::chunk(bool empty, const vec3& chunkPos)
-    : nBlocks_(0) {
+    : bitsPerBlock_(0),
+      blockDataVersion_(0),
+      storageView_(nullptr),
+      dirtySections_(CHUNK_ALL_SECTIONS),
+      partVertexOffsets_(),
+      partsMeshingMode_(chunkMeshingMode::NAIVE),
+      lod_(0),
+      nBlocks_(0) {
 
         renderingData_.chunkPos = chunkPos;
 
-        if (empty) {
+        for (int i = 0; i < 6; i++)
+            neighbors_[i] = nullptr;
+
+        {
         
             std::unique_lock<std::shared_mutex> lock(blocksMutex_);
 
-            for (GLbyte x = 0; x < SCX; x++)
-                for (GLbyte y = 0; y < SCY; y++)
-                    for (GLbyte z = 0; z < SCZ; z++)
-                        blocks_[x][y][z] = 0;
+            setUniform_(0);
         
         }
-        else
+
+        if (!empty) {
+
             worldGen::generate(*this); // This can only call to setBlock to modify the chunk and that method already takes care of 'blocksMutex_'.
+            compact();
+
+        }
         
     }
 
     chunk::chunk(const chunk& chunk)
-    : nBlocks_(chunk.nBlocks_.load()) {
+    : palette_(chunk.palette_),
+      blockWords_(chunk.blockWords_),
+      bitsPerBlock_(chunk.bitsPerBlock_),
+      blockDataVersion_(0),
+      storageView_(nullptr),
+      dirtySections_(CHUNK_ALL_SECTIONS),
+      partVertexOffsets_(),
+      partsMeshingMode_(chunkMeshingMode::NAIVE),
+      lod_(0),
+      nBlocks_(chunk.nBlocks_.load()) {
 
-        std::unique_lock<std::shared_mutex> lock(blocksMutex_);
+        renderingData_.chunkPos = chunk.renderingData_.chunkPos;
 
-        for (GLbyte x = 0; x < SCX; x++)
-            for (GLbyte y = 0; y < SCY; y++)
-                for (GLbyte z = 0; z < SCZ; z++)
-                    blocks_[x][y][z] = chunk.blocks_[x][y][z];
+        for (int i = 0; i < 6; i++)
+            neighbors_[i] = nullptr;
 
-        renderingData_.chunkPos = chunk.renderingData_.chunkPos;
+        publishStorage_();
 
     }
 
-    block chunk::getBlock(GLbyte x, GLbyte y, GLbyte z) {
+    chunk::~chunk() {
 
-        std::unique_lock<std::shared_mutex> lock(blocksMutex_);
+        releaseSpareMeshes_();
+        delete storageView_.load();
 
-        return blocks_[x][y][z];
+    }
+
+    block chunk::getBlock(GLbyte x, GLbyte y, GLbyte z) {
+
+        return readBlock_(linearIndex_(x, y, z));
 
     }
 
     block chunk::getBlock(const vec3& inChunkPos) {
 
-        std::unique_lock<std::shared_mutex> lock(blocksMutex_);
-
-        return blocks_[(unsigned int)inChunkPos.x][(unsigned int)inChunkPos.y][(unsigned int)inChunkPos.z];
+        return readBlock_(linearIndex_((unsigned int)inChunkPos.x, (unsigned int)inChunkPos.y, (unsigned int)inChunkPos.z));
 
     }
 
@@ -113,15 +320,7 @@ namespace VoxelEng {
 
         changed_ = true;
 
-        if (blocks_[x][y][z] == 0 && blockID != 0)
-            nBlocks_++;
-        else
-            if (blocks_[x][y][z] != 0 && blockID == 0 && nBlocks_ != 0)
-                nBlocks_--;
-
-        block oldID = blocks_[x][y][z];
-        blocks_[x][y][z] = blockID;
-        return oldID;
+        return setBlock_(linearIndex_(x, y, z), blockID);
 
     }
 
@@ -131,57 +330,48 @@ namespace VoxelEng {
 
         changed_ = true;
 
-        if (blocks_[x][y][z] == 0 && blockID != 0)
-            nBlocks_++;
-        else
-            if (blocks_[x][y][z] != 0 && blockID == 0 && nBlocks_ != 0)
-                nBlocks_--;
-
-        block oldID = blocks_[x][y][z];
-        blocks_[x][y][z] = blockID;
-        return oldID;
+        return setBlock_(linearIndex_(x, y, z), blockID);
 
     }
 
     block chunk::setBlock(unsigned int linearIndex, block blockID) {
 
-        GLbyte x = linearIndex / (SCZ * SCY),
-               y = (linearIndex / SCZ) % SCY,
-               z = linearIndex % SCZ;
-
         std::unique_lock<std::shared_mutex> lock(blocksMutex_);
 
         changed_ = true;
 
-        if (blocks_[x][y][z] == 0 && blockID != 0)
-            nBlocks_++;
-        else
-            if (blocks_[x][y][z] != 0 && blockID == 0 && nBlocks_ != 0)
-                nBlocks_--;
-
-        block oldID = blocks_[x][y][z];
-        blocks_[x][y][z] = blockID;
-        return oldID;
+        return setBlock_(linearIndex, blockID);
 
     }
 
     void chunk::renewMesh() {
 
-        renderingData_.vertices.clear();
-        if (nBlocks_) {
+        // The meshing mode is read once, before the dirty sections, so that the whole mesh is built with it.
+        // The vertex offsets of the mesh's parts are only valid for the mode they were built with.
+        chunkMeshingMode meshingMode = meshingMode_;
+        std::uint64_t dirtySections = dirtySections_.exchange(0);
 
-            block blockID = 0;
+        if (!nBlocks_) {
+
+            keepSpareMesh_(std::move(renderingData_.mesh));
+            std::fill(std::begin(partVertexOffsets_), std::end(partVertexOffsets_), 0);
+            partsMeshingMode_ = meshingMode;
+
+        }
+        else if (dirtySections) {
 
+            // The neighbor chunks cannot be reused for other chunk positions while they are read here.
+            chunkReadGuard guard;
 
             // Get information about neighbor chunks.
-            std::vector<chunk*> neighborChunks = {
+            chunk* neighborChunks[6] = {
 
-                chunkManager::selectChunk(renderingData_.chunkPos.x, renderingData_.chunkPos.y, renderingData_.chunkPos.z + 1), // front
-                chunkManager::selectChunk(renderingData_.chunkPos.x, renderingData_.chunkPos.y, renderingData_.chunkPos.z - 1), // back
-                chunkManager::selectChunk(renderingData_.chunkPos.x, renderingData_.chunkPos.y + 1, renderingData_.chunkPos.z), // top
-                chunkManager::selectChunk(renderingData_.chunkPos.x, renderingData_.chunkPos.y - 1, renderingData_.chunkPos.z), // bottom
-                chunkManager::selectChunk(renderingData_.chunkPos.x + 1, renderingData_.chunkPos.y, renderingData_.chunkPos.z), // right
-                chunkManager::selectChunk(renderingData_.chunkPos.x - 1, renderingData_.chunkPos.y, renderingData_.chunkPos.z) // left
+                neighbor(blockViewDir::PLUSZ), // front
+                neighbor(blockViewDir::NEGZ), // back
+                neighbor(blockViewDir::PLUSY), // top
+                neighbor(blockViewDir::NEGY), // bottom
+                neighbor(blockViewDir::PLUSX), // right
+                neighbor(blockViewDir::NEGX) // left
 
             };
 
@@ -210,473 +400,1733 @@ namespace VoxelEng {
                 neighborChunks[5]->blockDataMutex().lock_shared();
 
 
-            // Determine model from block's ID.
-            vertex aux;
-            for (unsigned int x = 0; x < SCX; x++)
-                for (unsigned int y = 0; y < SCY; y++)
-                    for (unsigned int z = 0; z < SCZ; z++) {
+            // Copy the blocks that are needed to mesh the chunk so that
+            // no locks are held while the mesh is generated.
+            copyPaddedBlocks_(neighborChunks, paddedBlocks_);
 
-                        // Add block's model to the mesh if necessary.
-                        if (blockID = blocks_[x][y][z]) {
 
-                            bool DEBUG = blockID >= 7 && blockID <= 10;
-                            //bool DEBUG = false;
+            // Unlock neighbors' data.
+            blocksMutex_.unlock_shared();
 
-                            // Front face vertices with culling of non-visible faces. z+
-                            if (DEBUG || (z < 15 && !blocks_[x][y][z + 1]) || (z == 15 && neighborChunks[0] && !neighborChunks[0]->blocks_[x][y][0])) {
+            if (neighborChunks[0])
+                neighborChunks[0]->blockDataMutex().unlock_shared();
 
-                                // Create the face's vertices.
-                                for (int vertex = 0; vertex < blockTriangles_->operator[](0).size(); vertex++) {
+            if (neighborChunks[1])
+                neighborChunks[1]->blockDataMutex().unlock_shared();
 
-                                    aux.positions[0] = renderingData_.chunkPos.x * SCX + x + blockVertices_->operator[](blockTriangles_->operator[](1)[vertex]).positions[0];
-                                    aux.positions[1] = renderingData_.chunkPos.y * SCY + y + blockVertices_->operator[](blockTriangles_->operator[](1)[vertex]).positions[1];
-                                    aux.positions[2] = renderingData_.chunkPos.z * SCZ + z + blockVertices_->operator[](blockTriangles_->operator[](1)[vertex]).positions[2];
+            if (neighborChunks[2])
+                neighborChunks[2]->blockDataMutex().unlock_shared();
 
-                                    aux.normals = 0 | (0 << 30);
-                                    aux.normals = aux.normals | (1023 << 20);
-                                    aux.normals = aux.normals | (512 << 10);
-                                    aux.normals = aux.normals | (512 << 0);
+            if (neighborChunks[3])
+                neighborChunks[3]->blockDataMutex().unlock_shared();
 
-                                    renderingData_.vertices.push_back(aux);
+            if (neighborChunks[4])
+                neighborChunks[4]->blockDataMutex().unlock_shared();
 
-                                }
+            if (neighborChunks[5])
+                neighborChunks[5]->blockDataMutex().unlock_shared();
 
-                                // Add texture to the face.
-                                models::addTexture(blockID, blockID, renderingData_.vertices);
+            // Read chunk data section ends.
 
-                            }
 
-                            // Back face vertices with culling of non-visible faces. z-
-                            if (DEBUG || (z > 0 && !blocks_[x][y][z - 1]) || (z == 0 && neighborChunks[1] && !neighborChunks[1]->blocks_[x][y][15])) {
+            // The rendering thread uses the face connectivity of the chunk to skip the chunks hidden behind solid ones.
+            // It is computed before the borders of the padded blocks are modified below.
+            std::uint64_t faceConnectivity = (nBlocks_ == N_CHUNK_BLOCKS) ? 0 : computeFaceConnectivity_(paddedBlocks_);
 
-                                // Create the face's vertices
-                                for (int vertex = 0; vertex < blockTriangles_->operator[](0).size(); vertex++) {
 
-                                    aux.positions[0] = renderingData_.chunkPos.x * SCX + x + blockVertices_->operator[](blockTriangles_->operator[](0)[vertex]).positions[0];
-                                    aux.positions[1] = renderingData_.chunkPos.y * SCY + y + blockVertices_->operator[](blockTriangles_->operator[](0)[vertex]).positions[1];
-                                    aux.positions[2] = renderingData_.chunkPos.z * SCZ + z + blockVertices_->operator[](blockTriangles_->operator[](0)[vertex]).positions[2];
+            // Chunks at a level of detail other than 0 are meshed from a downsampled copy of their
+            // blocks. Their whole mesh is rebuilt, as sections are not aligned with the downsampled cells.
+            // The faces at the borders with neighbor chunks at a different level of detail are always
+            // generated, so that no gaps are left between their meshes.
+            unsigned int lod = lod_,
+                         scale = 1 << lod;
+            const block* blocks = paddedBlocks_;
 
-                                    aux.normals = 0 | (0 << 30);
-                                    aux.normals = aux.normals | (0 << 20);
-                                    aux.normals = aux.normals | (512 << 10);
-                                    aux.normals = aux.normals | (512 << 0);
+            for (unsigned int face = 0; face < 6; face++)
+                if (neighborChunks[face] && neighborChunks[face]->lod() != lod)
+                    clearPaddedBorder_(face, paddedBlocks_);
 
-                                    renderingData_.vertices.push_back(aux);
+            if (lod) {
 
-                                }
+                downsampleBlocks_(paddedBlocks_, scale, lodBlocks_);
+                blocks = lodBlocks_;
+                dirtySections = CHUNK_ALL_SECTIONS;
 
-                                // Add texture to the face.
-                                models::addTexture(blockID, blockID, renderingData_.vertices);
+            }
 
-                            }
+            if (meshingMode != partsMeshingMode_) {
 
-                            // Top face vertices with culling of non-visible faces. y+
-                            if (DEBUG || (y < 15 && !blocks_[x][y + 1][z]) || (y == 15 && neighborChunks[2] && !neighborChunks[2]->blocks_[x][0][z])) {
+                dirtySections = CHUNK_ALL_SECTIONS;
+                partsMeshingMode_ = meshingMode;
 
-                                // Create the face's vertices
-                                for (int vertex = 0; vertex < blockTriangles_->operator[](0).size(); vertex++) {
+            }
 
-                                    aux.positions[0] = renderingData_.chunkPos.x * SCX + x + blockVertices_->operator[](blockTriangles_->operator[](2)[vertex]).positions[0];
-                                    aux.positions[1] = renderingData_.chunkPos.y * SCY + y + blockVertices_->operator[](blockTriangles_->operator[](2)[vertex]).positions[1];
-                                    aux.positions[2] = renderingData_.chunkPos.z * SCZ + z + blockVertices_->operator[](blockTriangles_->operator[](2)[vertex]).positions[2];
 
-                                    aux.normals = 0 | (0 << 30);
-                                    aux.normals = aux.normals | (512 << 20);
-                                    aux.normals = aux.normals | (1023 << 10);
-                                    aux.normals = aux.normals | (512 << 0);
+            // Compute which block faces are visible.
+            faceMasks faces;
+            buildFaceMasks_(blocks, SCX / scale, faces);
 
-                                    renderingData_.vertices.push_back(aux);
 
-                                }
+            // Dirty parts are meshed again while the vertices of the rest of parts are spliced from the current mesh.
+            // Naive meshing divides the mesh in sections. Greedy meshing divides it in face layers instead, so that
+            // faces are merged across the whole chunk, and rebuilds each face layer that crosses a dirty section.
+            // The new mesh's size is known beforehand, so it is built without reallocations.
+            bool greedyMeshing = meshingMode == chunkMeshingMode::GREEDY,
+                 dirtyParts[CHUNK_N_FACE_LAYERS];
+            unsigned int nParts = greedyMeshing ? CHUNK_N_FACE_LAYERS : CHUNK_N_SECTIONS;
+            for (unsigned int part = 0; part < nParts; part++)
+                dirtyParts[part] = dirtySections & (greedyMeshing ? layerSections_(part) : 1ull << part);
 
-                                // Add texture to the face.
-                                models::addTexture(blockID, blockID, renderingData_.vertices);
+            std::size_t nVertices = 0;
+            for (unsigned int part = 0; part < nParts; part++)
+                if (!dirtyParts[part])
+                    nVertices += partVertexOffsets_[part + 1] - partVertexOffsets_[part];
+                else if (greedyMeshing)
+                    nVertices += countLayerFaces_(part, faces) * CHUNK_VERTICES_PER_FACE;
+                else
+                    nVertices += countSectionFaces_(part, faces) * CHUNK_VERTICES_PER_FACE;
 
-                            }
+            chunkMesh newMesh = takeSpareMesh_();
+            std::vector<chunkVertex>& vertices = newMesh->vertices;
+            vertices.clear();
+            vertices.reserve(nVertices);
 
-                            // Bottom face vertices with culling of non-visible faces. y-
-                            if (DEBUG || (y > 0 && !blocks_[x][y - 1][z]) || (y == 0 && neighborChunks[3] && !neighborChunks[3]->blocks_[x][15][z])) {
+            unsigned int partStart = 0;
+            for (unsigned int part = 0; part < nParts; part++) {
 
-                                // Create the face's vertices
-                                for (int vertex = 0; vertex < blockTriangles_->operator[](0).size(); vertex++) {
+                partStart = vertices.size();
 
-                                    aux.positions[0] = renderingData_.chunkPos.x * SCX + x + blockVertices_->operator[](blockTriangles_->operator[](3)[vertex]).positions[0];
-                                    aux.positions[1] = renderingData_.chunkPos.y * SCY + y + blockVertices_->operator[](blockTriangles_->operator[](3)[vertex]).positions[1];
-                                    aux.positions[2] = renderingData_.chunkPos.z * SCZ + z + blockVertices_->operator[](blockTriangles_->operator[](3)[vertex]).positions[2];
+                if (dirtyParts[part]) {
 
-                                    aux.normals = 0 | (0 << 30);
-                                    aux.normals = aux.normals | (512 << 20);
-                                    aux.normals = aux.normals | (0 << 10);
-                                    aux.normals = aux.normals | (512 << 0);
+                    if (greedyMeshing)
+                        greedyMeshLayer_(part, blocks, faces, vertices);
+                    else
+                        meshSection_(part, blocks, faces, vertices);
 
-                                    renderingData_.vertices.push_back(aux);
+                }
+                else if (partVertexOffsets_[part] != partVertexOffsets_[part + 1])
+                    vertices.insert(vertices.end(),
+                                    renderingData_.mesh->vertices.begin() + partVertexOffsets_[part],
+                                    renderingData_.mesh->vertices.begin() + partVertexOffsets_[part + 1]);
 
-                                }
+                partVertexOffsets_[part] = partStart;
 
-                                // Add texture to the face.
-                                models::addTexture(blockID, blockID, renderingData_.vertices);
+            }
+            partVertexOffsets_[nParts] = vertices.size();
 
-                            }
+            if (lod)
+                scaleVertices_(vertices, scale);
 
-                            // Right face vertices with culling of non-visible faces. x+
-                            if (DEBUG || (x < 15 && !blocks_[x + 1][y][z]) || (x == 15 && neighborChunks[4] && !neighborChunks[4]->blocks_[0][y][z])) {
+            // The new mesh is published and the old one is kept to build the next meshes.
+            newMesh->version = ++nMeshesBuilt_;
+            newMesh->faceConnectivity = faceConnectivity;
+            renderingData_.mesh.swap(newMesh);
+            keepSpareMesh_(std::move(newMesh));
 
-                                // Create the face's vertices
-                                for (int vertex = 0; vertex < blockTriangles_->operator[](0).size(); vertex++) {
+        }
 
-                                    aux.positions[0] = renderingData_.chunkPos.x * SCX + x + blockVertices_->operator[](blockTriangles_->operator[](5)[vertex]).positions[0];
-                                    aux.positions[1] = renderingData_.chunkPos.y * SCY + y + blockVertices_->operator[](blockTriangles_->operator[](5)[vertex]).positions[1];
-                                    aux.positions[2] = renderingData_.chunkPos.z * SCZ + z + blockVertices_->operator[](blockTriangles_->operator[](5)[vertex]).positions[2];
+    }
 
-                                    aux.normals = 0 | (0 << 30);
-                                    aux.normals = aux.normals | (512 << 20);
-                                    aux.normals = aux.normals | (512 << 10);
-                                    aux.normals = aux.normals | (1023 << 0);
+    chunkMesh chunk::takeSpareMesh_() {
 
-                                    renderingData_.vertices.push_back(aux);
+        for (chunkMesh& mesh : spareMeshes_)
+            if (mesh && mesh.use_count() == 1) {
 
-                                }
+                // Synchronise with the rendering thread's release of the mesh.
+                std::atomic_thread_fence(std::memory_order_acquire);
 
-                                // Add texture to the face.
-                                models::addTexture(blockID, blockID, renderingData_.vertices);
+                nSpareMeshes_--;
 
-                            }
+                return std::move(mesh);
 
-                            // Left face vertices with culling of non-visible faces. x-
-                            if (DEBUG || (x > 0 && !blocks_[x - 1][y][z]) || (x == 0 && neighborChunks[5] && !neighborChunks[5]->blocks_[15][y][z])) {
+            }
 
-                                // Create the face's vertices
-                                for (int vertex = 0; vertex < blockTriangles_->operator[](0).size(); vertex++) {
+        return std::make_shared<chunkMeshData>();
 
-                                    aux.positions[0] = renderingData_.chunkPos.x * SCX + x + blockVertices_->operator[](blockTriangles_->operator[](4)[vertex]).positions[0];
-                                    aux.positions[1] = renderingData_.chunkPos.y * SCY + y + blockVertices_->operator[](blockTriangles_->operator[](4)[vertex]).positions[1];
-                                    aux.positions[2] = renderingData_.chunkPos.z * SCZ + z + blockVertices_->operator[](blockTriangles_->operator[](4)[vertex]).positions[2];
+    }
 
-                                    aux.normals = 0 | (0 << 30);
-                                    aux.normals = aux.normals | (512 << 20);
-                                    aux.normals = aux.normals | (512 << 10);
-                                    aux.normals = aux.normals | (0 << 0);
+    void chunk::keepSpareMesh_(chunkMesh mesh) {
 
-                                    renderingData_.vertices.push_back(aux);
+        if (!mesh)
+            return;
 
-                                }
+        for (chunkMesh& slot : spareMeshes_)
+            if (!slot) {
 
-                                // Add texture to the face.
-                                models::addTexture(blockID, blockID, renderingData_.vertices);
+                unsigned int nSpareMeshes = nSpareMeshes_.load();
+                do {
 
-                            }
+                    if (nSpareMeshes >= CHUNK_MAX_SPARE_MESHES)
+                        return;
 
-                        }
+                } while (!nSpareMeshes_.compare_exchange_weak(nSpareMeshes, nSpareMeshes + 1));
 
-                    }
+                slot = std::move(mesh);
 
+                return;
 
-            // Unlock neighbors' data.
-            blocksMutex_.unlock_shared();
+            }
 
-            if (neighborChunks[0])
-                neighborChunks[0]->blockDataMutex().unlock_shared();
+    }
 
-            if (neighborChunks[1])
-                neighborChunks[1]->blockDataMutex().unlock_shared();
+    void chunk::releaseSpareMeshes_() {
 
-            if (neighborChunks[2])
-                neighborChunks[2]->blockDataMutex().unlock_shared();
+        for (chunkMesh& mesh : spareMeshes_)
+            if (mesh) {
 
-            if (neighborChunks[3])
-                neighborChunks[3]->blockDataMutex().unlock_shared();
+                mesh.reset();
+                nSpareMeshes_--;
 
-            if (neighborChunks[4])
-                neighborChunks[4]->blockDataMutex().unlock_shared();
+            }
 
-            if (neighborChunks[5])
-                neighborChunks[5]->blockDataMutex().unlock_shared();
+    }
 
-            // Read chunk data section ends.
+    void chunk::copyPaddedBlocks_(chunk* const neighborChunks[6], block* paddedBlocks) {
 
-        }
+        unsigned int pos[3] = { 0, 0, 0 },
+                     paddedPos[3] = { 0, 0, 0 };
 
-    }
+        // The chunk's blocks.
+        if (uniform())
+            std::fill(paddedBlocks, paddedBlocks + CHUNK_PADDED_VOLUME, palette_[0]);
+        else
+            for (unsigned int x = 0; x < SCX; x++)
+                for (unsigned int y = 0; y < SCY; y++)
+                    for (unsigned int z = 0; z < SCZ; z++)
+                        paddedBlocks[paddedIndex_(x + 1, y + 1, z + 1)] = getBlock_(linearIndex_(x, y, z));
 
-    void chunk::makeEmpty() {
-    
-        std::unique_lock<std::shared_mutex> lock(blocksMutex_);
+        // The blocks of the neighbor chunks that touch the chunk's faces. Missing neighbor chunks
+        // are considered solid so that no faces are generated towards them.
+        for (unsigned int face = 0; face < 6; face++) {
 
-        changed_ = true;
-        nBlocks_ = 0;
+            unsigned int n = MESH_FACE_AXIS[face],
+                         u = (n + 1) % 3,
+                         v = (n + 2) % 3;
+            chunk* neighborChunk = neighborChunks[face];
 
-        for (GLbyte x = 0; x < SCX; x++)
-            for (GLbyte y = 0; y < SCY; y++)
-                for (GLbyte z = 0; z < SCZ; z++)
-                    blocks_[x][y][z] = 0;
+            pos[n] = MESH_FACE_POSITIVE[face] ? 0 : SCX - 1;
+            paddedPos[n] = MESH_FACE_POSITIVE[face] ? CHUNK_PADDED_SIZE - 1 : 0;
+            for (unsigned int i = 0; i < SCX; i++)
+                for (unsigned int j = 0; j < SCX; j++) {
 
-    }
+                    pos[u] = i;
+                    pos[v] = j;
+                    paddedPos[u] = i + 1;
+                    paddedPos[v] = j + 1;
 
-    void chunk::regenChunk(bool empty, const vec3& chunkPos) {
-    
-        makeEmpty();
-        renderingData_.chunkPos = chunkPos;
-        
-        if (!empty)
-            worldGen::generate(*this);
-    
-    }
+                    paddedBlocks[paddedIndex_(paddedPos[0], paddedPos[1], paddedPos[2])] =
+                        neighborChunk ? neighborChunk->getBlock_(linearIndex_(pos[0], pos[1], pos[2])) : MESH_MISSING_NEIGHBOR_BLOCK;
 
-    void chunk::cleanUp() {
-    
-        blockVertices_ = nullptr;
-        blockTriangles_ = nullptr;
+                }
 
-        initialised_ = false;
-    
-    }
+        }
 
+    }
 
-    // 'chunkManager' class.
+    std::uint64_t chunk::computeFaceConnectivity_(const block* paddedBlocks) {
 
-    bool chunkManager::initialised_ = false,
-         chunkManager::infiniteWorld_ = false;
-    int chunkManager::nChunksToCompute_ = 0;
-    std::unordered_map<vec3, chunk*> chunkManager::chunks_;
-    std::unordered_map<vec3, std::vector<vertex>>* chunkManager::drawableChunksWrite_ = nullptr,
-                                                 * chunkManager::drawableChunksRead_ = nullptr;
-    std::deque<chunk*> chunkManager::freeChunks_;
-    std::unordered_set<vec3> chunkManager::freeableChunks_;
+        // Steps along each axis to the adjacent block across each face (in the order used by the meshers).
+        const int steps[6][3] = { {0, 0, 1}, {0, 0, -1}, {0, 1, 0}, {0, -1, 0}, {1, 0, 0}, {-1, 0, 0} };
+        const int size[3] = { SCX, SCY, SCZ };
+        std::bitset<N_CHUNK_BLOCKS> visited;
+        std::uint64_t faceConnectivity = 0;
 
-    std::deque<vec3> chunkManager::priorityMeshingList_;
-    std::deque<vec3> chunkManager::priorityUpdateList_;
+        for (unsigned int x = 0; x < SCX; x++)
+            for (unsigned int y = 0; y < SCY; y++)
+                for (unsigned int z = 0; z < SCZ; z++) {
 
-    std::mutex chunkManager::freeableChunksMutex_,
-               chunkManager::managerThreadMutex_,
-               chunkManager::loadingTerrainMutex_;
-    std::shared_mutex chunkManager::highPriorityMutex_;
-    std::recursive_mutex chunkManager::drawableChunksWriteMutex_,
-                         chunkManager::chunksMutex_,
-                         chunkManager::freeChunksMutex_,
-                         chunkManager::priorityMeshingListMutex_;
-    std::condition_variable chunkManager::managerThreadCV_,
-                            chunkManager::loadingTerrainCV_;
-    std::condition_variable_any chunkManager::highPriorityUpdatesCV_;
+                    if (paddedBlocks[paddedIndex_(x + 1, y + 1, z + 1)] || visited[linearIndex_(x, y, z)])
+                        continue;
 
-    std::atomic<bool> chunkManager::forceSyncFlag_ = false,
-                      chunkManager::waitTerrainLoaded_ = true;
+                    // Flood fill the region of non-solid blocks that contains the starting block,
+                    // gathering the faces of the chunk that it touches.
+                    // Pending blocks are stored with their coordinates packed in 4 bits each.
+                    unsigned int nPending = 0,
+                                 touchedFaces = 0;
+                    floodFillStack_[nPending++] = x | (y << 4) | (z << 8);
+                    visited[linearIndex_(x, y, z)] = true;
+                    while (nPending) {
 
-    unsigned int chunkManager::parseChunkPosState_ = 0;
-    const unsigned int chunkManager::parseChunkPosStates_ = 2;
-    std::string chunkManager::openedTerrainFileName_ = "";
+                        std::uint16_t packedPos = floodFillStack_[--nPending];
+                        int pos[3] = { packedPos & 15, (packedPos >> 4) & 15, packedPos >> 8 };
 
-    std::unordered_map<unsigned int, std::unordered_map<vec3, bool>> chunkManager::AIChunkAvailable_;
-    std::unordered_map<unsigned int, std::unordered_map<vec3, chunk*>> chunkManager::AIagentChunks_;
-    unsigned int chunkManager::selectedAIWorld_ = 0;
+                        for (unsigned int face = 0; face < 6; face++) {
 
-    bool chunkManager::originalWorldAccess_ = true;
+                            int next[3] = { pos[0] + steps[face][0], pos[1] + steps[face][1], pos[2] + steps[face][2] };
 
+                            if (next[0] < 0 || next[0] >= size[0] || next[1] < 0 || next[1] >= size[1] || next[2] < 0 || next[2] >= size[2])
+                                touchedFaces |= 1u << face;
+                            else if (!paddedBlocks[paddedIndex_(next[0] + 1, next[1] + 1, next[2] + 1)] && !visited[linearIndex_(next[0], next[1], next[2])]) {
 
-    void chunkManager::init(unsigned int nChunksToCompute) {
+                                visited[linearIndex_(next[0], next[1], next[2])] = true;
+                                floodFillStack_[nPending++] = next[0] | (next[1] << 4) | (next[2] << 8);
 
-        if (initialised_)
-            logger::errorLog("Chunk management system was already initialised");
-        else {
+                            }
 
-            infiniteWorld_ = false;
+                        }
 
-            nChunksToCompute_ = nChunksToCompute;
+                    }
 
-            forceSyncFlag_ = false;
-            waitTerrainLoaded_ = true;
+                    for (unsigned int face1 = 0; face1 < 6; face1++)
+                        if (touchedFaces & (1u << face1))
+                            for (unsigned int face2 = 0; face2 < 6; face2++)
+                                if (touchedFaces & (1u << face2))
+                                    faceConnectivity |= 1ull << (face1 * 6 + face2);
 
-            openedTerrainFileName_ = "";
+                    if (faceConnectivity == CHUNK_ALL_FACES_CONNECTED)
+                        return faceConnectivity;
 
-            originalWorldAccess_ = true;
+                }
 
-            initialised_ = true;
+        return faceConnectivity;
 
-            parseChunkPosState_ = 0;
-            selectedAIWorld_ = 0;
+    }
 
-            if (!game::AImodeON()) {
-            
-                drawableChunksRead_ = new std::unordered_map<vec3, std::vector<vertex>>;
-                drawableChunksWrite_ = new std::unordered_map<vec3, std::vector<vertex>>;
-            
-            }
+    void chunk::clearPaddedBorder_(unsigned int face, block* paddedBlocks) {
 
-        } 
+        unsigned int n = MESH_FACE_AXIS[face],
+                     u = (n + 1) % 3,
+                     v = (n + 2) % 3,
+                     paddedPos[3] = { 0, 0, 0 };
 
-    }
+        paddedPos[n] = MESH_FACE_POSITIVE[face] ? CHUNK_PADDED_SIZE - 1 : 0;
+        for (unsigned int i = 0; i < CHUNK_PADDED_SIZE; i++)
+            for (unsigned int j = 0; j < CHUNK_PADDED_SIZE; j++) {
 
-    vec3 chunkManager::getChunkRelCoords(float globalX, float globalY, float globalZ) {
+                paddedPos[u] = i;
+                paddedPos[v] = j;
 
-        int floorX = std::floor(globalX),
-            floorY = std::floor(globalY),
-            floorZ = std::floor(globalZ);
+                paddedBlocks[paddedIndex_(paddedPos[0], paddedPos[1], paddedPos[2])] = 0;
 
-        return vec3(floorMod((floorX >= 0) ? floorX : SCX + floorX, SCX),
-                    floorMod((floorY >= 0) ? floorY : SCY + floorY, SCY),
-                    floorMod((floorZ >= 0) ? floorZ : SCZ + floorZ, SCZ));
+            }
 
     }
 
-    block chunkManager::getBlock(int posX, int posY, int posZ) {
+    void chunk::downsampleBlocks_(const block* paddedBlocks, unsigned int scale, block* lodBlocks) {
 
-        block selectedBlock = 0;
-        std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
+        const unsigned int maxScale = 1 << (CHUNK_N_LODS - 1),
+                           size = SCX / scale;
 
+        block candidates[maxScale * maxScale * maxScale];
+        unsigned int votes[maxScale * maxScale * maxScale],
+                     nCandidates = 0,
+                     best = 0,
+                     cell[3] = { 0, 0, 0 },
+                     start[3] = { 0, 0, 0 },
+                     end[3] = { 0, 0, 0 },
+                     candidate = 0;
+        block blockID = 0;
 
-        if (game::AImodeON()) {
+        for (cell[0] = 0; cell[0] < size + 2; cell[0]++)
+            for (cell[1] = 0; cell[1] < size + 2; cell[1]++)
+                for (cell[2] = 0; cell[2] < size + 2; cell[2]++) {
 
-            if (originalWorldAccess_ || AIagentChunks_.find(selectedAIWorld_) == AIagentChunks_.cend())
+                    // Blocks of 'paddedBlocks' that the cell covers.
+                    for (unsigned int axis = 0; axis < 3; axis++)
+                        if (cell[axis] == 0) {
+
+                            start[axis] = 0;
+                            end[axis] = 1;
+
+                        }
+                        else if (cell[axis] == size + 1) {
+
+                            start[axis] = CHUNK_PADDED_SIZE - 1;
+                            end[axis] = CHUNK_PADDED_SIZE;
+
+                        }
+                        else {
+
+                            start[axis] = 1 + (cell[axis] - 1) * scale;
+                            end[axis] = start[axis] + scale;
+
+                        }
+
+                    // Majority vote.
+                    nCandidates = 0;
+                    for (unsigned int x = start[0]; x < end[0]; x++)
+                        for (unsigned int y = start[1]; y < end[1]; y++)
+                            for (unsigned int z = start[2]; z < end[2]; z++) {
+
+                                blockID = paddedBlocks[paddedIndex_(x, y, z)];
+
+                                for (candidate = 0; candidate < nCandidates && candidates[candidate] != blockID; candidate++);
+
+                                if (candidate == nCandidates) {
+
+                                    candidates[nCandidates] = blockID;
+                                    votes[nCandidates++] = 1;
+
+                                }
+                                else
+                                    votes[candidate]++;
+
+                            }
+
+                    best = 0;
+                    for (candidate = 1; candidate < nCandidates; candidate++)
+                        if (votes[candidate] > votes[best] || (votes[candidate] == votes[best] && !candidates[best]))
+                            best = candidate;
+
+                    lodBlocks[paddedIndex_(cell[0], cell[1], cell[2])] = candidates[best];
+
+                }
+
+    }
+
+    void chunk::buildFaceMasks_(const block* paddedBlocks, unsigned int size, faceMasks& faces) {
+
+        // Columns of solid blocks along each axis, indexed like the face masks. Bits 1 to 'size' hold the
+        // chunk's blocks, while bits 0 and 'size' + 1 hold the blocks of the neighbor chunks at both ends.
+        std::uint32_t solid[3][SCX][SCX];
+        unsigned int paddedPos[3] = { 0, 0, 0 };
+
+        std::fill(&solid[0][0][0], &solid[0][0][0] + 3 * SCX * SCX, 0u);
+
+        for (unsigned int x = 0; x < size; x++)
+            for (unsigned int y = 0; y < size; y++)
+                for (unsigned int z = 0; z < size; z++)
+                    if (paddedBlocks[paddedIndex_(x + 1, y + 1, z + 1)]) {
+
+                        solid[0][y][z] |= 1u << (x + 1);
+                        solid[1][z][x] |= 1u << (y + 1);
+                        solid[2][x][y] |= 1u << (z + 1);
+
+                    }
+
+        for (unsigned int face = 0; face < 6; face++) {
+
+            unsigned int n = MESH_FACE_AXIS[face],
+                         u = (n + 1) % 3,
+                         v = (n + 2) % 3;
+            std::uint32_t endBit = MESH_FACE_POSITIVE[face] ? 1u << (size + 1) : 1u;
+
+            paddedPos[n] = MESH_FACE_POSITIVE[face] ? size + 1 : 0;
+            for (unsigned int i = 0; i < size; i++)
+                for (unsigned int j = 0; j < size; j++) {
+
+                    paddedPos[u] = i + 1;
+                    paddedPos[v] = j + 1;
+
+                    if (paddedBlocks[paddedIndex_(paddedPos[0], paddedPos[1], paddedPos[2])])
+                        solid[n][i][j] |= endBit;
+
+                }
+
+        }
+
+        // A face is visible when its block is solid and the next block in the face's direction is not.
+        // Only the faces of the chunk's blocks are kept, as the end bits of the neighbor chunks can be
+        // visible too and, below the highest level of detail, they fall inside the face masks' bits.
+        const std::uint32_t chunkBits = (1u << size) - 1;
+        std::uint32_t column = 0;
+        for (unsigned int face = 0; face < 6; face++) {
+
+            unsigned int n = MESH_FACE_AXIS[face];
+
+            for (unsigned int i = 0; i < SCX; i++)
+                for (unsigned int j = 0; j < SCX; j++) {
+
+                    column = solid[n][i][j];
+                    column &= MESH_FACE_POSITIVE[face] ? ~(column >> 1) : ~(column << 1);
+                    faces.masks[face][i][j] = static_cast<std::uint16_t>((column >> 1) & chunkBits);
+
+                }
+
+        }
+
+    }
+
+    void chunk::scaleVertices_(std::vector<chunkVertex>& vertices, unsigned int scale) {
+
+        // The scaled coordinates still fit in their bit fields (see 'chunkVertex'),
+        // so all of them are scaled at once.
+        const GLuint scaledBits = 0x7FFFu | (0x3FFu << 18);
+
+        for (chunkVertex& meshVertex : vertices)
+            meshVertex.position = (meshVertex.position & scaledBits) * scale | (meshVertex.position & ~scaledBits);
+
+    }
+
+    void chunk::addFace_(unsigned int face, const unsigned int pos[3], const unsigned int extent[3], block blockID, std::vector<chunkVertex>& vertices) {
+
+        const faceTemplate& faceTemplate = faceTemplates_[face];
+        GLuint origin = pos[0] | (pos[1] << 5) | (pos[2] << 10);
+
+        // The template's vertices belong to a face of a single block, so they are
+        // stretched to the face's extent.
+        chunkVertex aux;
+        aux.textureID = blockID;
+        for (unsigned int corner = 0; corner < CHUNK_VERTICES_PER_FACE; corner++) {
+
+            aux.position = faceTemplate.vertices[corner] + origin;
+
+            for (unsigned int axis = 0; axis < 3; axis++)
+                if (faceTemplate.corners[corner] & (1 << axis))
+                    aux.position += (extent[axis] - 1) << (5 * axis);
+
+            if (faceTemplate.textureCorners[corner] & 1)
+                aux.position += (extent[faceTemplate.textureAxes[0]] - 1) << 18;
+
+            if (faceTemplate.textureCorners[corner] & 2)
+                aux.position += (extent[faceTemplate.textureAxes[1]] - 1) << 23;
+
+            vertices.push_back(aux);
+
+        }
+
+    }
+
+    unsigned int chunk::countSectionFaces_(unsigned int section, const faceMasks& faces) {
+
+        const unsigned int sectionOrigin[3] = {
+
+            section / (CHUNK_SECTIONS_PER_AXIS * CHUNK_SECTIONS_PER_AXIS) * CHUNK_SECTION_SIZE,
+            section / CHUNK_SECTIONS_PER_AXIS % CHUNK_SECTIONS_PER_AXIS * CHUNK_SECTION_SIZE,
+            section % CHUNK_SECTIONS_PER_AXIS * CHUNK_SECTION_SIZE
+
+        };
+        const unsigned int sectionBits = (1u << CHUNK_SECTION_SIZE) - 1;
+
+        unsigned int nFaces = 0;
+        for (unsigned int face = 0; face < 6; face++) {
+
+            unsigned int n = MESH_FACE_AXIS[face],
+                         u = (n + 1) % 3,
+                         v = (n + 2) % 3;
+
+            for (unsigned int i = sectionOrigin[u]; i < sectionOrigin[u] + CHUNK_SECTION_SIZE; i++)
+                for (unsigned int j = sectionOrigin[v]; j < sectionOrigin[v] + CHUNK_SECTION_SIZE; j++)
+                    nFaces += std::popcount((faces.masks[face][i][j] >> sectionOrigin[n]) & sectionBits);
+
+        }
+
+        return nFaces;
+
+    }
+
+    void chunk::meshSection_(unsigned int section, const block* paddedBlocks, const faceMasks& faces, std::vector<chunkVertex>& vertices) {
+
+        const unsigned int sectionOrigin[3] = {
+
+            section / (CHUNK_SECTIONS_PER_AXIS * CHUNK_SECTIONS_PER_AXIS) * CHUNK_SECTION_SIZE,
+            section / CHUNK_SECTIONS_PER_AXIS % CHUNK_SECTIONS_PER_AXIS * CHUNK_SECTION_SIZE,
+            section % CHUNK_SECTIONS_PER_AXIS * CHUNK_SECTION_SIZE
+
+        };
+        const unsigned int sectionBits = (1u << CHUNK_SECTION_SIZE) - 1,
+                           blockExtent[3] = { 1, 1, 1 };
+
+        unsigned int pos[3] = { 0, 0, 0 },
+                     visible = 0;
+        for (unsigned int face = 0; face < 6; face++) {
+
+            unsigned int n = MESH_FACE_AXIS[face],
+                         u = (n + 1) % 3,
+                         v = (n + 2) % 3;
+
+            for (unsigned int i = 0; i < CHUNK_SECTION_SIZE; i++)
+                for (unsigned int j = 0; j < CHUNK_SECTION_SIZE; j++) {
+
+                    pos[u] = sectionOrigin[u] + i;
+                    pos[v] = sectionOrigin[v] + j;
+
+                    // Visit the visible faces of the section's part of the column.
+                    visible = (faces.masks[face][pos[u]][pos[v]] >> sectionOrigin[n]) & sectionBits;
+                    while (visible) {
+
+                        pos[n] = sectionOrigin[n] + std::countr_zero(visible);
+                        visible &= visible - 1;
+
+                        addFace_(face, pos, blockExtent, paddedBlocks[paddedIndex_(pos[0] + 1, pos[1] + 1, pos[2] + 1)], vertices);
+
+                    }
+
+                }
+
+        }
+
+    }
+
+    unsigned int chunk::countLayerFaces_(unsigned int layer, const faceMasks& faces) {
+
+        unsigned int face = layer / SCX,
+                     slice = layer % SCX,
+                     nFaces = 0;
+
+        for (unsigned int i = 0; i < SCX; i++)
+            for (unsigned int j = 0; j < SCX; j++)
+                nFaces += (faces.masks[face][i][j] >> slice) & 1;
+
+        return nFaces;
+
+    }
+
+    void chunk::greedyMeshLayer_(unsigned int layer, const block* paddedBlocks, const faceMasks& faces, std::vector<chunkVertex>& vertices) {
+
+        unsigned int face = layer / SCX,
+                     n = MESH_FACE_AXIS[face],
+                     u = (n + 1) % 3,
+                     v = (n + 2) % 3;
+
+        block mask[SCX][SCX],
+              blockID = 0;
+        unsigned int pos[3] = { 0, 0, 0 },
+                     extent[3] = { 0, 0, 0 },
+                     width = 0,
+                     height = 0;
+        bool sameRow = false;
+
+        pos[n] = layer % SCX;
+
+        // Build the mask with the IDs of the blocks whose face is visible in this layer.
+        for (unsigned int j = 0; j < SCX; j++)
+            for (unsigned int i = 0; i < SCX; i++) {
+
+                pos[u] = i;
+                pos[v] = j;
+
+                mask[j][i] = ((faces.masks[face][i][j] >> pos[n]) & 1) ? paddedBlocks[paddedIndex_(pos[0] + 1, pos[1] + 1, pos[2] + 1)] : 0;
+
+            }
+
+        // Merge the visible faces into rectangles, growing them first along the U axis and then along the V axis.
+        for (unsigned int j = 0; j < SCX; j++)
+            for (unsigned int i = 0; i < SCX; i++) {
+
+                if (!(blockID = mask[j][i]))
+                    continue;
+
+                width = 1;
+                while (i + width < SCX && mask[j][i + width] == blockID)
+                    width++;
+
+                height = 1;
+                sameRow = true;
+                while (sameRow && j + height < SCX) {
+
+                    for (unsigned int k = i; sameRow && k < i + width; k++)
+                        sameRow = mask[j + height][k] == blockID;
+
+                    if (sameRow)
+                        height++;
+
+                }
+
+                for (unsigned int l = j; l < j + height; l++)
+                    for (unsigned int k = i; k < i + width; k++)
+                        mask[l][k] = 0;
+
+                // Create the quad by scaling the block's face to the rectangle's size.
+                pos[u] = i;
+                pos[v] = j;
+                extent[n] = 1;
+                extent[u] = width;
+                extent[v] = height;
+
+                addFace_(face, pos, extent, blockID, vertices);
+
+            }
+
+    }
+
+    void chunk::makeEmpty() {
+    
+        std::unique_lock<std::shared_mutex> lock(blocksMutex_);
+
+        changed_ = true;
+
+        beginBlockDataWrite_();
+        setUniform_(0);
+        endBlockDataWrite_();
+
+        markAllDirty_();
+
+    }
+
+    void chunk::makeUniform(block blockID) {
+
+        std::unique_lock<std::shared_mutex> lock(blocksMutex_);
+
+        changed_ = true;
+
+        beginBlockDataWrite_();
+        setUniform_(blockID);
+        endBlockDataWrite_();
+
+        markAllDirty_();
+
+    }
+
+    void chunk::fillBox(GLbyte x1, GLbyte y1, GLbyte z1, GLbyte x2, GLbyte y2, GLbyte z2, block blockID) {
+
+        chunkEditSession session(*this);
+
+        session.fillBox(x1, y1, z1, x2, y2, z2, blockID);
+
+    }
+
+    void chunk::setBlockRun(unsigned int linearIndex, unsigned int length, block blockID) {
+
+        chunkEditSession session(*this);
+
+        session.setBlockRun(linearIndex, length, blockID);
+
+    }
+
+    void chunk::setBlocks(std::span<const blockEdit> edits) {
+
+        chunkEditSession session(*this);
+
+        session.setBlocks(edits);
+
+    }
+
+    bool chunk::compact() {
+
+        std::unique_lock<std::shared_mutex> lock(blocksMutex_);
+
+        if (bitsPerBlock_ != 0) {
+
+            block firstID = getBlock_(0);
+
+            for (unsigned int i = 1; i < N_CHUNK_BLOCKS; i++)
+                if (getBlock_(i) != firstID)
+                    return false;
+
+            beginBlockDataWrite_();
+            setUniform_(firstID);
+            endBlockDataWrite_();
+
+        }
+
+        return true;
+
+    }
+
+    std::size_t chunk::blockDataSize() {
+
+        std::shared_lock<std::shared_mutex> lock(blocksMutex_);
+
+        return palette_.capacity() * sizeof(block) + blockWords_.capacity() * sizeof(std::uint64_t);
+
+    }
+
+    block chunk::setBlock_(unsigned int linearIndex, block blockID) {
+
+        block oldID = getBlock_(linearIndex);
+
+        if (oldID != blockID) {
+
+            if (oldID == 0 && blockID != 0)
+                nBlocks_++;
+            else
+                if (oldID != 0 && blockID == 0 && nBlocks_ != 0)
+                    nBlocks_--;
+
+            beginBlockDataWrite_();
+            writeBlock_(linearIndex, blockID);
+            endBlockDataWrite_();
+
+            std::uint64_t sections = 0,
+                          neighborSections[6] = { 0, 0, 0, 0, 0, 0 };
+            blockDirtySections_(linearIndex, sections, neighborSections);
+            markDirty_(sections, neighborSections);
+
+        }
+
+        return oldID;
+
+    }
+
+    void chunk::writeBlock_(unsigned int linearIndex, block blockID) {
+
+        if (getBlock_(linearIndex) != blockID) {
+
+            std::uint64_t value = paletteIndex_(blockID); // This may repack the block data, so it must be obtained before computing the bit offset.
+            std::size_t bit = static_cast<std::size_t>(linearIndex) * bitsPerBlock_;
+            std::uint64_t mask = ((1ull << bitsPerBlock_) - 1) << (bit & 63);
+            blockWords_[bit >> 6] = (blockWords_[bit >> 6] & ~mask) | (value << (bit & 63));
+
+        }
+
+    }
+
+    unsigned int chunk::sectionIndex_(unsigned int x, unsigned int y, unsigned int z) {
+
+        return ((x / CHUNK_SECTION_SIZE) * CHUNK_SECTIONS_PER_AXIS + y / CHUNK_SECTION_SIZE) * CHUNK_SECTIONS_PER_AXIS + z / CHUNK_SECTION_SIZE;
+
+    }
+
+    void chunk::blockDirtySections_(unsigned int linearIndex, std::uint64_t& sections, std::uint64_t neighborSections[6]) {
+
+        unsigned int x = 0,
+                     y = 0,
+                     z = 0;
+        blockCoords_(linearIndex, x, y, z);
+
+        sections |= 1ull << sectionIndex_(x, y, z);
+
+        // A block's faces can only hide or reveal the faces of the blocks next to it,
+        // so only the sections that share a face with the block's own section can change.
+        if (x % CHUNK_SECTION_SIZE == 0 && x > 0)
+            sections |= 1ull << sectionIndex_(x - 1, y, z);
+        if (x % CHUNK_SECTION_SIZE == CHUNK_SECTION_SIZE - 1 && x < SCX - 1)
+            sections |= 1ull << sectionIndex_(x + 1, y, z);
+
+        if (y % CHUNK_SECTION_SIZE == 0 && y > 0)
+            sections |= 1ull << sectionIndex_(x, y - 1, z);
+        if (y % CHUNK_SECTION_SIZE == CHUNK_SECTION_SIZE - 1 && y < SCY - 1)
+            sections |= 1ull << sectionIndex_(x, y + 1, z);
+
+        if (z % CHUNK_SECTION_SIZE == 0 && z > 0)
+            sections |= 1ull << sectionIndex_(x, y, z - 1);
+        if (z % CHUNK_SECTION_SIZE == CHUNK_SECTION_SIZE - 1 && z < SCZ - 1)
+            sections |= 1ull << sectionIndex_(x, y, z + 1);
+
+        // Blocks in the chunk's boundary also affect the neighbor chunks.
+        if (x == 0)
+            neighborSections[static_cast<int>(blockViewDir::NEGX) - 1] |= 1ull << sectionIndex_(SCX - 1, y, z);
+        else if (x == SCX - 1)
+            neighborSections[static_cast<int>(blockViewDir::PLUSX) - 1] |= 1ull << sectionIndex_(0, y, z);
+
+        if (y == 0)
+            neighborSections[static_cast<int>(blockViewDir::NEGY) - 1] |= 1ull << sectionIndex_(x, SCY - 1, z);
+        else if (y == SCY - 1)
+            neighborSections[static_cast<int>(blockViewDir::PLUSY) - 1] |= 1ull << sectionIndex_(x, 0, z);
+
+        if (z == 0)
+            neighborSections[static_cast<int>(blockViewDir::NEGZ) - 1] |= 1ull << sectionIndex_(x, y, SCZ - 1);
+        else if (z == SCZ - 1)
+            neighborSections[static_cast<int>(blockViewDir::PLUSZ) - 1] |= 1ull << sectionIndex_(x, y, 0);
+
+    }
+
+    std::uint64_t chunk::borderSections_(blockViewDir direction) {
+
+        vec3 dir = uDirectionToVec3(direction);
+        std::uint64_t sections = 0;
+        unsigned int last = CHUNK_SECTIONS_PER_AXIS - 1,
+                     sectionX = 0,
+                     sectionY = 0,
+                     sectionZ = 0;
+        for (unsigned int section = 0; section < CHUNK_N_SECTIONS; section++) {
+
+            sectionX = section / (CHUNK_SECTIONS_PER_AXIS * CHUNK_SECTIONS_PER_AXIS);
+            sectionY = section / CHUNK_SECTIONS_PER_AXIS % CHUNK_SECTIONS_PER_AXIS;
+            sectionZ = section % CHUNK_SECTIONS_PER_AXIS;
+
+            if ((dir.x > 0 && sectionX == last) || (dir.x < 0 && sectionX == 0) ||
+                (dir.y > 0 && sectionY == last) || (dir.y < 0 && sectionY == 0) ||
+                (dir.z > 0 && sectionZ == last) || (dir.z < 0 && sectionZ == 0))
+                sections |= 1ull << section;
+
+        }
+
+        return sections;
+
+    }
+
+    std::uint64_t chunk::layerSections_(unsigned int layer) {
+
+        unsigned int n = MESH_FACE_AXIS[layer / SCX],
+                     sectionSlice = layer % SCX / CHUNK_SECTION_SIZE,
+                     sectionCoords[3] = { 0, 0, 0 };
+        std::uint64_t sections = 0;
+        for (unsigned int section = 0; section < CHUNK_N_SECTIONS; section++) {
+
+            sectionCoords[0] = section / (CHUNK_SECTIONS_PER_AXIS * CHUNK_SECTIONS_PER_AXIS);
+            sectionCoords[1] = section / CHUNK_SECTIONS_PER_AXIS % CHUNK_SECTIONS_PER_AXIS;
+            sectionCoords[2] = section % CHUNK_SECTIONS_PER_AXIS;
+
+            if (sectionCoords[n] == sectionSlice)
+                sections |= 1ull << section;
+
+        }
+
+        return sections;
+
+    }
+
+    void chunk::markDirty_(std::uint64_t sections, const std::uint64_t neighborSections[6]) {
+
+        dirtySections_.fetch_or(sections);
+
+        chunk* neighborChunk = nullptr;
+        for (int i = 0; i < 6; i++)
+            if (neighborSections[i] && (neighborChunk = neighbors_[i].load(std::memory_order_acquire))) {
+
+                neighborChunk->dirtySections_.fetch_or(neighborSections[i]);
+                neighborChunk->changed_ = true;
+
+            }
+
+    }
+
+    void chunk::markAllDirty_() {
+
+        std::uint64_t neighborSections[6];
+        for (int i = 0; i < 6; i++)
+            neighborSections[i] = borderSections_(inverseUDirection(static_cast<blockViewDir>(i + 1)));
+
+        markDirty_(CHUNK_ALL_SECTIONS, neighborSections);
+
+    }
+
+    void chunk::countBlocks_() {
+
+        if (bitsPerBlock_ == 0)
+            nBlocks_ = (palette_[0]) ? N_CHUNK_BLOCKS : 0;
+        else {
+
+            unsigned int nBlocks = 0;
+            for (unsigned int i = 0; i < N_CHUNK_BLOCKS; i++)
+                if (getBlock_(i))
+                    nBlocks++;
+
+            nBlocks_ = nBlocks;
+
+        }
+
+    }
+
+    void chunk::copyBlocks_(const chunk& other) {
+
+        // Buffers are reused when they are big enough, so that refreshing
+        // the same chunk copy several times does not keep retiring storage.
+        if (palette_.capacity() < other.palette_.size()) {
+
+            retiredPalettes_.push_back(std::move(palette_));
+            palette_ = std::vector<block>();
+
+        }
+        palette_.assign(other.palette_.begin(), other.palette_.end());
+
+        if (blockWords_.capacity() < other.blockWords_.size()) {
+
+            retiredBlockWords_.push_back(std::move(blockWords_));
+            blockWords_ = std::vector<std::uint64_t>();
+
+        }
+        blockWords_.assign(other.blockWords_.begin(), other.blockWords_.end());
+
+        bitsPerBlock_ = other.bitsPerBlock_;
+        nBlocks_ = other.nBlocks_.load();
+
+        const chunkBlockStorageView* view = storageView_.load();
+        if (view->bitsPerBlock != bitsPerBlock_ || view->palette != palette_.data() || view->words != blockWords_.data() ||
+            (bitsPerBlock_ != 0 && bitsPerBlock_ != CHUNK_RAW_BLOCK_BITS && palette_.capacity() < (1u << bitsPerBlock_)))
+            publishStorage_();
+
+        markAllDirty_();
+
+    }
+
+    unsigned int chunk::paletteIndex_(block blockID) {
+
+        if (bitsPerBlock_ == CHUNK_RAW_BLOCK_BITS)
+            return blockID;
+
+        for (unsigned int i = 0; i < palette_.size(); i++)
+            if (palette_[i] == blockID)
+                return i;
+
+        // The block ID is not in the palette yet.
+        // Uniform chunks are materialised here the first time a different block ID is placed in them.
+        if (palette_.size() == (1u << bitsPerBlock_)) {
+
+            if (bitsPerBlock_ == CHUNK_MAX_PALETTE_BITS) {
+
+                repackBlocks_(CHUNK_RAW_BLOCK_BITS);
+                return blockID;
+
+            }
+            else
+                repackBlocks_((bitsPerBlock_ == 0) ? 1 : bitsPerBlock_ * 2);
+
+        }
+
+        palette_.push_back(blockID);
+        return palette_.size() - 1;
+
+    }
+
+    void chunk::repackBlocks_(unsigned int bitsPerBlock) {
+
+        std::vector<std::uint64_t> newWords(N_CHUNK_BLOCKS * bitsPerBlock / 64, 0);
+        bool raw = bitsPerBlock == CHUNK_RAW_BLOCK_BITS;
+
+        for (unsigned int i = 0; i < N_CHUNK_BLOCKS; i++) {
+
+            std::uint64_t value = 0;
+            if (raw)
+                value = getBlock_(i);
+            else if (bitsPerBlock_ != 0)
+                value = (blockWords_[(i * bitsPerBlock_) >> 6] >> ((i * bitsPerBlock_) & 63)) & ((1ull << bitsPerBlock_) - 1);
+
+            std::size_t bit = static_cast<std::size_t>(i) * bitsPerBlock;
+            newWords[bit >> 6] |= value << (bit & 63);
+
+        }
+
+        // Readers may still be using the old block data, so it is retired instead of freed.
+        if (blockWords_.capacity())
+            retiredBlockWords_.push_back(std::move(blockWords_));
+        blockWords_ = std::move(newWords);
+        bitsPerBlock_ = bitsPerBlock;
+
+        if (raw) {
+
+            retiredPalettes_.push_back(std::move(palette_));
+            palette_ = std::vector<block>();
+
+        }
+
+        publishStorage_();
+
+    }
+
+    void chunk::setUniform_(block blockID) {
+
+        nBlocks_ = (blockID) ? N_CHUNK_BLOCKS : 0;
+
+        if (bitsPerBlock_ == 0 && storageView_.load())
+            palette_[0] = blockID;
+        else {
+
+            if (palette_.capacity())
+                retiredPalettes_.push_back(std::move(palette_));
+            if (blockWords_.capacity())
+                retiredBlockWords_.push_back(std::move(blockWords_));
+
+            palette_ = std::vector<block>(1, blockID);
+            blockWords_ = std::vector<std::uint64_t>();
+            bitsPerBlock_ = 0;
+
+            publishStorage_();
+
+        }
+
+    }
+
+    void chunk::publishStorage_() {
+
+        if (bitsPerBlock_ != 0 && bitsPerBlock_ != CHUNK_RAW_BLOCK_BITS && palette_.capacity() < (1u << bitsPerBlock_)) {
+
+            std::vector<block> palette;
+            palette.reserve(1u << bitsPerBlock_);
+            palette.assign(palette_.begin(), palette_.end());
+
+            if (palette_.capacity())
+                retiredPalettes_.push_back(std::move(palette_));
+            palette_ = std::move(palette);
+
+        }
+
+        const chunkBlockStorageView* oldView = storageView_.exchange(new chunkBlockStorageView{ bitsPerBlock_, palette_.data(), blockWords_.data() },
+                                                                     std::memory_order_acq_rel);
+
+        // New readers can only reach the view that has just been published, so the replaced
+        // view and buffers are freed once the readers that started before are done.
+        chunkReclaimer::retire(std::move(retiredPalettes_), std::move(retiredBlockWords_), oldView);
+        retiredPalettes_.clear();
+        retiredBlockWords_.clear();
+
+    }
+
+    void chunk::regenChunk(bool empty, const vec3& chunkPos) {
+    
+        makeEmpty();
+        renderingData_.chunkPos = chunkPos;
+        
+        if (!empty) {
+
+            worldGen::generate(*this);
+            compact();
+
+        }
+    
+    }
+
+    void chunk::reset_() {
+
+        for (int i = 0; i < 6; i++)
+            neighbors_[i].store(nullptr, std::memory_order_relaxed);
+
+        dirtySections_ = CHUNK_ALL_SECTIONS;
+        std::fill(std::begin(partVertexOffsets_), std::end(partVertexOffsets_), 0);
+        partsMeshingMode_ = chunkMeshingMode::NAIVE;
+        lod_ = 0;
+        changed_ = false;
+        loadLevel_ = chunkLoadLevel::NOTLOADED;
+
+        renderingData_.mesh.reset();
+        releaseSpareMeshes_();
+
+    }
+
+    void chunk::cleanUp() {
+    
+        blockVertices_ = nullptr;
+        blockTriangles_ = nullptr;
+
+        initialised_ = false;
+    
+    }
+
+
+    // 'chunkEditSession' class.
+
+    chunkEditSession::chunkEditSession(chunk& chunk)
+    : chunk_(chunk),
+      lock_(chunk.blocksMutex_),
+      modified_(false),
+      dirtySections_(0),
+      neighborDirtySections_() {
+
+        chunk_.beginBlockDataWrite_();
+
+    }
+
+    void chunkEditSession::setBlockRun(unsigned int linearIndex, unsigned int length, block blockID) {
+
+        if (linearIndex == 0 && length >= N_CHUNK_BLOCKS)
+            chunk_.setUniform_(blockID);
+        else {
+
+            unsigned int end = std::min(linearIndex + length, (unsigned int)N_CHUNK_BLOCKS);
+            for (unsigned int i = linearIndex; i < end; i++)
+                chunk_.writeBlock_(i, blockID);
+
+        }
+
+        dirtySections_ = CHUNK_ALL_SECTIONS;
+        modified_ = true;
+
+    }
+
+    void chunkEditSession::fillBox(GLbyte x1, GLbyte y1, GLbyte z1, GLbyte x2, GLbyte y2, GLbyte z2, block blockID) {
+
+        GLbyte minX = std::min(x1, x2), maxX = std::max(x1, x2),
+               minY = std::min(y1, y2), maxY = std::max(y1, y2),
+               minZ = std::min(z1, z2), maxZ = std::max(z1, z2);
+
+        if (minX == 0 && minY == 0 && minZ == 0 && maxX == SCX - 1 && maxY == SCY - 1 && maxZ == SCZ - 1)
+            chunk_.setUniform_(blockID);
+        else if (!chunk_.uniform() || chunk_.getBlock_(0) != blockID)
+            for (GLbyte x = minX; x <= maxX; x++)
+                for (GLbyte y = minY; y <= maxY; y++)
+                    for (GLbyte z = minZ; z <= maxZ; z++)
+                        chunk_.writeBlock_(chunk::linearIndex_(x, y, z), blockID);
+
+        dirtySections_ = CHUNK_ALL_SECTIONS;
+        modified_ = true;
+
+    }
+
+    void chunkEditSession::setBlocks(std::span<const blockEdit> edits) {
+
+        for (auto it = edits.begin(); it != edits.end(); it++) {
+
+            chunk_.writeBlock_(it->linearIndex, it->blockID);
+            chunk::blockDirtySections_(it->linearIndex, dirtySections_, neighborDirtySections_);
+
+        }
+
+        modified_ = true;
+
+    }
+
+    chunkEditSession::~chunkEditSession() {
+
+        if (modified_) {
+
+            chunk_.countBlocks_();
+            chunk_.changed_ = true;
+
+            if (dirtySections_ == CHUNK_ALL_SECTIONS)
+                chunk_.markAllDirty_();
+            else
+                chunk_.markDirty_(dirtySections_, neighborDirtySections_);
+
+        }
+
+        chunk_.endBlockDataWrite_();
+
+    }
+
+
+    // 'chunkPool' class.
+
+    std::vector<chunkPool::slab> chunkPool::slabs_;
+    std::deque<chunkPool::releasedChunk> chunkPool::freeChunks_;
+    std::size_t chunkPool::capacity_ = 0,
+                chunkPool::nAcquiredChunks_ = 0;
+    std::mutex chunkPool::mutex_;
+
+
+    void chunkPool::reserve(std::size_t nChunks) {
+
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        if (nChunks > capacity_)
+            allocateSlab_(nChunks - capacity_);
+
+    }
+
+    std::size_t chunkPool::capacity() {
+
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        return capacity_;
+
+    }
+
+    std::size_t chunkPool::nAcquiredChunks() {
+
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        return nAcquiredChunks_;
+
+    }
+
+    chunk* chunkPool::acquire(bool empty, const vec3& chunkPos) {
+
+        chunk* selectedChunk = nullptr;
+        void* slot = nullptr;
+
+        {
+
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            // Chunks are released in epoch order, so if the oldest one can still be held
+            // by a lock-free reader, so can the rest of them.
+            if (freeChunks_.empty() || !chunkReclaimer::isSafe(freeChunks_.front().epoch))
+                slot = allocateSlot_();
+            else {
+
+                selectedChunk = freeChunks_.front().selectedChunk;
+                freeChunks_.pop_front();
+
+            }
+
+            nAcquiredChunks_++;
+
+        }
+
+        // Chunks are generated outside the pool's lock as world generation can be slow.
+        if (selectedChunk) {
+
+            selectedChunk->reset_();
+            selectedChunk->regenChunk(empty, chunkPos);
+
+        }
+        else
+            selectedChunk = new (slot) chunk(empty, chunkPos);
+
+        return selectedChunk;
+
+    }
+
+    chunk* chunkPool::acquire(const chunk& original) {
+
+        chunk* selectedChunk = nullptr;
+        void* slot = nullptr;
+
+        {
+
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            // Chunks are released in epoch order, so if the oldest one can still be held
+            // by a lock-free reader, so can the rest of them.
+            if (freeChunks_.empty() || !chunkReclaimer::isSafe(freeChunks_.front().epoch))
+                slot = allocateSlot_();
+            else {
+
+                selectedChunk = freeChunks_.front().selectedChunk;
+                freeChunks_.pop_front();
+
+            }
+
+            nAcquiredChunks_++;
+
+        }
+
+        if (selectedChunk) {
+
+            std::unique_lock<std::shared_mutex> lock(selectedChunk->blocksMutex_);
+
+            selectedChunk->reset_();
+            selectedChunk->beginBlockDataWrite_();
+            selectedChunk->copyBlocks_(original);
+            selectedChunk->endBlockDataWrite_();
+
+            selectedChunk->renderingData_.chunkPos = original.renderingData_.chunkPos;
+
+        }
+        else
+            selectedChunk = new (slot) chunk(original);
+
+        return selectedChunk;
+
+    }
+
+    void chunkPool::release(chunk* selectedChunk) {
+
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        freeChunks_.push_back({ selectedChunk, chunkReclaimer::retireEpoch() });
+        nAcquiredChunks_--;
+
+    }
+
+    void chunkPool::cleanUp() {
+
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        for (auto it = slabs_.begin(); it != slabs_.end(); it++) {
+
+            for (std::size_t i = 0; i < it->nConstructed; i++)
+                reinterpret_cast<chunk*>(it->slots + i * slotSize_)->~chunk();
+
+            ::operator delete(it->slots, std::align_val_t(CHUNK_POOL_ALIGNMENT));
+
+        }
+        slabs_.clear();
+
+        freeChunks_.clear();
+        capacity_ = 0;
+        nAcquiredChunks_ = 0;
+
+    }
+
+    void* chunkPool::allocateSlot_() {
+
+        // Slabs are filled in allocation order.
+        auto it = slabs_.begin();
+        while (it != slabs_.end() && it->nConstructed == it->nSlots)
+            it++;
+
+        if (it == slabs_.end()) {
+
+            allocateSlab_(CHUNK_POOL_SLAB_SIZE);
+            it = slabs_.end() - 1;
+
+        }
+
+        return it->slots + it->nConstructed++ * slotSize_;
+
+    }
+
+    void chunkPool::allocateSlab_(std::size_t nSlots) {
+
+        slab newSlab;
+        newSlab.slots = static_cast<unsigned char*>(::operator new(nSlots * slotSize_, std::align_val_t(CHUNK_POOL_ALIGNMENT)));
+        newSlab.nSlots = nSlots;
+        newSlab.nConstructed = 0;
+
+        slabs_.push_back(newSlab);
+        capacity_ += nSlots;
+
+    }
+
+
+    // 'chunkManager' class.
+
+    bool chunkManager::initialised_ = false,
+         chunkManager::infiniteWorld_ = false;
+    int chunkManager::nChunksToCompute_ = 0;
+    std::unordered_map<vec3, chunk*> chunkManager::chunks_;
+    std::unordered_map<vec3, chunkMesh>* chunkManager::drawableChunksWrite_ = nullptr,
+                                                 * chunkManager::drawableChunksRead_ = nullptr;
+    std::unordered_set<vec3> chunkManager::freeableChunks_;
+
+    std::deque<vec3> chunkManager::priorityMeshingList_;
+    std::deque<vec3> chunkManager::priorityUpdateList_;
+    std::priority_queue<chunkMeshingJob> chunkManager::meshingJobs_;
+
+    std::mutex chunkManager::freeableChunksMutex_,
+               chunkManager::meshingJobsMutex_,
+               chunkManager::managerThreadMutex_,
+               chunkManager::loadingTerrainMutex_;
+    std::shared_mutex chunkManager::highPriorityMutex_,
+                      chunkManager::chunksMutex_,
+                      chunkManager::AIChunksMutex_;
+    std::recursive_mutex chunkManager::drawableChunksWriteMutex_,
+                         chunkManager::priorityMeshingListMutex_;
+    std::condition_variable chunkManager::managerThreadCV_,
+                            chunkManager::loadingTerrainCV_;
+    std::condition_variable_any chunkManager::highPriorityUpdatesCV_;
+
+    std::atomic<unsigned int> chunkManager::lodDistances_[CHUNK_N_LODS] = { DEF_CHUNK_LOD_DISTANCES[0], DEF_CHUNK_LOD_DISTANCES[1], DEF_CHUNK_LOD_DISTANCES[2] };
+
+    std::atomic<bool> chunkManager::forceSyncFlag_ = false,
+                      chunkManager::waitTerrainLoaded_ = true;
+
+    unsigned int chunkManager::parseChunkPosState_ = 0;
+    const unsigned int chunkManager::parseChunkPosStates_ = 2;
+    std::string chunkManager::openedTerrainFileName_ = "";
+
+    std::unordered_map<unsigned int, std::unordered_map<vec3, bool>> chunkManager::AIChunkAvailable_;
+    std::unordered_map<unsigned int, std::unordered_map<vec3, chunk*>> chunkManager::AIagentChunks_;
+    unsigned int chunkManager::selectedAIWorld_ = 0;
+
+    bool chunkManager::originalWorldAccess_ = true;
+
+    std::atomic<chunkGrid*> chunkManager::chunkGrid_ = nullptr;
+    std::vector<chunkGrid*> chunkManager::retiredChunkGrids_;
+    std::atomic<unsigned int> chunkManager::nOutOfGridChunks_ = 0;
+
+
+    void chunkManager::init(unsigned int nChunksToCompute) {
+
+        if (initialised_)
+            logger::errorLog("Chunk management system was already initialised");
+        else {
+
+            infiniteWorld_ = false;
+
+            nChunksToCompute_ = nChunksToCompute;
+            reserveChunkPool_();
+
+            forceSyncFlag_ = false;
+            waitTerrainLoaded_ = true;
+
+            openedTerrainFileName_ = "";
+
+            originalWorldAccess_ = true;
+
+            initialised_ = true;
+
+            parseChunkPosState_ = 0;
+            selectedAIWorld_ = 0;
+
+            if (!game::AImodeON()) {
+            
+                drawableChunksRead_ = new std::unordered_map<vec3, chunkMesh>;
+                drawableChunksWrite_ = new std::unordered_map<vec3, chunkMesh>;
+            
+            }
+
+        } 
+
+    }
+
+    vec3 chunkManager::getChunkRelCoords(float globalX, float globalY, float globalZ) {
+
+        int floorX = std::floor(globalX),
+            floorY = std::floor(globalY),
+            floorZ = std::floor(globalZ);
+
+        return vec3(floorMod((floorX >= 0) ? floorX : SCX + floorX, SCX),
+                    floorMod((floorY >= 0) ? floorY : SCY + floorY, SCY),
+                    floorMod((floorZ >= 0) ? floorZ : SCZ + floorZ, SCZ));
+
+    }
+
+    block chunkManager::getBlock(int posX, int posY, int posZ) {
+
+        chunkReadGuard guard;
+        block selectedBlock = 0;
+
+
+        if (game::AImodeON()) {
+
+            std::shared_lock<std::shared_mutex> lock(AIChunksMutex_);
+
+            chunk* selectedChunk = selectChunkForRead_(getChunkCoords(posX, posY, posZ));
+
+            if (selectedChunk)
+                selectedBlock = selectedChunk->readBlockUnguarded_(chunk::linearIndex_(floorMod(posX, SCX), floorMod(posY, SCY), floorMod(posZ, SCZ)));
+            else
                 selectedBlock = getBlockOGWorld_(posX, posY, posZ);
-            else {
 
-                std::unordered_map<vec3, chunk*>& AgentChunk = AIagentChunks_[selectedAIWorld_];
-                vec3 chunkPos = getChunkCoords(posX, posY, posZ);
+        }
+        else
+            selectedBlock = getBlockOGWorld_(posX, posY, posZ);
+
+
+        return selectedBlock;
+
+    }
+
+    std::vector<block> chunkManager::getBlocksBox(int x1, int y1, int z1, int x2, int y2, int z2) {
+
+        std::vector<block> blocks;
+        int iInc = (x1 <= x2) ? 1 : -1,
+            jInc = (y1 <= y2) ? 1 : -1,
+            kInc = (z1 <= z2) ? 1 : -1;
+        x2 += iInc; // To make the loop stop when (i, j, k), which started at (x1, y1, z1) has iterated
+        y2 += jInc; // through the box leading to (x2, y2, z2) and has also iterated said last point.
+        z2 += kInc;
+
+
+        chunkReadGuard guard;
+        std::shared_lock<std::shared_mutex> lock(AIChunksMutex_, std::defer_lock);
+        if (game::AImodeON())
+            lock.lock();
+
+        blocks.reserve(std::abs(x2 - x1) * std::abs(y2 - y1) * std::abs(z2 - z1));
+
+        // The selected chunk is cached between consecutive blocks of the box. Each block is still read
+        // through the chunk's storage view, which handles uniform chunks without reading block words
+        // and stays consistent if the chunk is modified while the box is read.
+        chunk* selectedChunk = nullptr;
+        vec3 chunkPos,
+             lastChunkPos;
+        bool firstChunk = true;
+        for (int i = x1; i != x2; i += iInc)
+            for (int j = y1; j != y2; j += jInc)
+                for (int k = z1; k != z2; k += kInc)
+                    if (isInWorld(i, j, k)) {
+
+                        chunkPos = getChunkCoords(i, j, k);
+                        if (firstChunk || chunkPos != lastChunkPos) {
+
+                            selectedChunk = selectChunkForRead_(chunkPos);
+
+                            lastChunkPos = chunkPos;
+                            firstChunk = false;
+
+                        }
+
+                        if (selectedChunk)
+                            blocks.push_back(selectedChunk->readBlockUnguarded_(chunk::linearIndex_(floorMod(i, SCX), floorMod(j, SCY), floorMod(k, SCZ))));
+                        else
+                            blocks.push_back(0);
+
+                    }
+                    else
+                        blocks.push_back(0);
+
+        return blocks;
+
+    }
+
+    chunkLoadLevel chunkManager::getChunkLoadLevel(const vec3& chunkPos) {
+
+        chunkReadGuard guard;
+        chunk* selectedChunk = findChunk_(chunkPos);
+
+        return (selectedChunk ? selectedChunk->loadLevel() : chunkLoadLevel::NOTLOADED);
+
+    }
+
+    void chunkManager::setAImode(bool on) {
+    
+        if (on) {
+        
+            if (drawableChunksRead_) {
+
+                delete drawableChunksRead_;
+                drawableChunksRead_ = nullptr;
+
+            }
+
+            if (drawableChunksWrite_) {
+
+                delete drawableChunksWrite_;
+                drawableChunksWrite_ = nullptr;
+
+            }
+        
+        }
+        else {
+        
+            if (!drawableChunksRead_)
+                drawableChunksRead_ = new std::unordered_map<vec3, chunkMesh>;
+
+            if (!drawableChunksWrite_)
+                drawableChunksWrite_ = new std::unordered_map<vec3, chunkMesh>;
+                
+        }
+    
+    }
+
+    void chunkManager::setNChunksToCompute(unsigned int nChunksToCompute) {
+    
+        // That is, if terrain has already been loaded, the number of chunks to compute
+        // cannot be changed (for now).
+
+        if (infiniteWorld_ || game::selectedEngineMode() != VoxelEng::engineMode::EDITLEVEL) {
+
+            nChunksToCompute_ = nChunksToCompute;
+            reserveChunkPool_();
+
+        }
+        else
+            logger::errorLog("Cannot change number of chunks to compute in a finite world that has been loaded.");
+    
+    }
+
+    void chunkManager::setLODDistance(unsigned int lod, unsigned int distance) {
+
+        if (lod == 0 || lod >= CHUNK_N_LODS)
+            logger::errorLog("Invalid chunk level of detail " + std::to_string(lod));
+        else
+            lodDistances_[lod] = distance;
+
+    }
+
+    void chunkManager::setChunkLOD(const vec3& chunkPos, unsigned int lod) {
+
+        if (lod >= CHUNK_N_LODS)
+            logger::errorLog("Invalid chunk level of detail " + std::to_string(lod));
+        else {
+
+            chunkReadGuard guard;
+            if (chunk* selectedChunk = selectChunkByChunkPos(chunkPos))
+                setChunkLOD_(selectedChunk, lod);
+            else
+                logger::errorLog("Chunk " + std::to_string(chunkPos.x) + "|" + std::to_string(chunkPos.y) + "|" + std::to_string(chunkPos.z) + " does not exist");
+
+        }
+
+    }
+
+    void chunkManager::setMeshingMode(chunkMeshingMode mode) {
+
+        if (chunk::meshingMode_.exchange(mode) != mode) {
+
+            std::shared_lock<std::shared_mutex> lock(chunksMutex_);
+
+            for (auto it = chunks_.begin(); it != chunks_.end(); it++) {
+
+                it->second->dirtySections_.fetch_or(CHUNK_ALL_SECTIONS);
+                it->second->changed_ = true;
+
+            }
+
+        }
+
+    }
+
+    block chunkManager::setBlock(int x, int y, int z, block blockID) {
+    
+        vec3 chunkPos = getChunkCoords(x, y, z);
+
+
+        chunkReadGuard guard;
+        std::unique_lock<std::shared_mutex> lock(AIChunksMutex_, std::defer_lock);
+        if (game::AImodeON())
+            lock.lock();
+
+        chunk* selectedChunk = selectChunkForWrite_(chunkPos);
+        if (selectedChunk) {
 
-                if (AgentChunk.find(chunkPos) == AgentChunk.cend() || !AIChunkAvailable_[selectedAIWorld_][chunkPos])
-                    selectedBlock = getBlockOGWorld_(posX, posY, posZ);
-                else
-                    selectedBlock = AgentChunk[chunkPos]->getBlock(floorMod(posX, SCX), floorMod(posY, SCY), floorMod(posZ, SCZ));
+            block removedBlock = selectedChunk->setBlock(getChunkRelCoords(x, y, z), blockID);
 
-            }
+            if (!game::AImodeON())
+                chunkManager::highPriorityUpdate(chunkPos);
+
+            return removedBlock;
 
         }
         else
-            selectedBlock = getBlockOGWorld_(posX, posY, posZ);
+            return 0;
 
+    }
 
-        return selectedBlock;
+    void chunkManager::fillBox(int x1, int y1, int z1, int x2, int y2, int z2, block blockID) {
 
-    }
+        vec3 minPos(std::min(x1, x2), std::min(y1, y2), std::min(z1, z2)),
+             maxPos(std::max(x1, x2), std::max(y1, y2), std::max(z1, z2)),
+             minChunkPos = getChunkCoords(minPos),
+             maxChunkPos = getChunkCoords(maxPos),
+             chunkPos,
+             chunkGlobalPos;
+        chunk* selectedChunk = nullptr;
 
-    std::vector<block> chunkManager::getBlocksBox(int x1, int y1, int z1, int x2, int y2, int z2) {
 
-        std::vector<block> blocks;
-        int iInc = (x1 <= x2) ? 1 : -1,
-            jInc = (y1 <= y2) ? 1 : -1,
-            kInc = (z1 <= z2) ? 1 : -1;
-        x2 += iInc; // To make the loop stop when (i, j, k), which started at (x1, y1, z1) has iterated
-        y2 += jInc; // through the box leading to (x2, y2, z2) and has also iterated said last point.
-        z2 += kInc;
+        chunkReadGuard guard;
+        std::unique_lock<std::shared_mutex> lock(AIChunksMutex_, std::defer_lock);
+        if (game::AImodeON())
+            lock.lock();
 
+        for (chunkPos.x = minChunkPos.x; chunkPos.x <= maxChunkPos.x; chunkPos.x++)
+            for (chunkPos.y = minChunkPos.y; chunkPos.y <= maxChunkPos.y; chunkPos.y++)
+                for (chunkPos.z = minChunkPos.z; chunkPos.z <= maxChunkPos.z; chunkPos.z++)
+                    if (selectedChunk = selectChunkForWrite_(chunkPos)) {
 
-        std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
-        for (int i = x1; i != x2; i += iInc) // No merece la pena hacer cach porque las posiciones de los bloques pueden estar puestas "a mala leche" y seguir dando un peor caso.
-            for (int j = y1; j != y2; j += jInc)
-                for (int k = z1; k != z2; k += kInc)
-                    blocks.push_back((isInWorld(i, j, k)) ? getBlock(i, j, k) : 0);
+                        // Intersect the box with the chunk.
+                        chunkGlobalPos = vec3(chunkPos.x * SCX, chunkPos.y * SCY, chunkPos.z * SCZ);
 
-        return blocks;
+                        {
 
-    }
+                            chunkEditSession session(*selectedChunk);
 
-    chunkLoadLevel chunkManager::getChunkLoadLevel(const vec3& chunkPos) {
+                            session.fillBox((GLbyte)std::max(minPos.x - chunkGlobalPos.x, 0.0f),
+                                            (GLbyte)std::max(minPos.y - chunkGlobalPos.y, 0.0f),
+                                            (GLbyte)std::max(minPos.z - chunkGlobalPos.z, 0.0f),
+                                            (GLbyte)std::min(maxPos.x - chunkGlobalPos.x, SCX - 1.0f),
+                                            (GLbyte)std::min(maxPos.y - chunkGlobalPos.y, SCY - 1.0f),
+                                            (GLbyte)std::min(maxPos.z - chunkGlobalPos.z, SCZ - 1.0f), blockID);
 
-        std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
+                        }
+
+                        if (!game::AImodeON())
+                            chunkManager::highPriorityUpdate(chunkPos);
 
-        return (chunks_.find(chunkPos) != chunks_.cend() ? chunks_[chunkPos]->loadLevel() : chunkLoadLevel::NOTLOADED);
+                    }
 
     }
 
-    void chunkManager::setAImode(bool on) {
-    
-        if (on) {
-        
-            if (drawableChunksRead_) {
+    void chunkManager::setBlocks(std::span<const worldBlockEdit> edits) {
 
-                delete drawableChunksRead_;
-                drawableChunksRead_ = nullptr;
+        std::optional<chunkEditSession> session;
+        vec3 chunkPos,
+             lastChunkPos;
+        bool firstEdit = true;
 
-            }
 
-            if (drawableChunksWrite_) {
+        chunkReadGuard guard;
+        std::unique_lock<std::shared_mutex> lock(AIChunksMutex_, std::defer_lock);
+        if (game::AImodeON())
+            lock.lock();
 
-                delete drawableChunksWrite_;
-                drawableChunksWrite_ = nullptr;
+        for (auto it = edits.begin(); it != edits.end(); it++) {
 
-            }
-        
-        }
-        else {
-        
-            if (!drawableChunksRead_)
-                drawableChunksRead_ = new std::unordered_map<vec3, std::vector<vertex>>;
+            chunkPos = getChunkCoords(it->pos);
 
-            if (!drawableChunksWrite_)
-                drawableChunksWrite_ = new std::unordered_map<vec3, std::vector<vertex>>;
-                
-        }
-    
-    }
+            // Consecutive edits in the same chunk share the same edit session.
+            if (firstEdit || chunkPos != lastChunkPos) {
 
-    void chunkManager::setNChunksToCompute(unsigned int nChunksToCompute) {
-    
-        // That is, if terrain has already been loaded, the number of chunks to compute
-        // cannot be changed (for now).
+                if (session) {
 
-        if (infiniteWorld_ || game::selectedEngineMode() != VoxelEng::engineMode::EDITLEVEL)
-            nChunksToCompute_ = nChunksToCompute;
-        else
-            logger::errorLog("Cannot change number of chunks to compute in a finite world that has been loaded.");
-    
-    }
+                    session.reset();
 
-    block chunkManager::setBlock(int x, int y, int z, block blockID) {
-    
-        vec3 chunkPos = getChunkCoords(x, y, z);
+                    if (!game::AImodeON())
+                        chunkManager::highPriorityUpdate(lastChunkPos);
 
+                }
 
-        std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
+                if (chunk* selectedChunk = selectChunkForWrite_(chunkPos))
+                    session.emplace(*selectedChunk);
+
+                lastChunkPos = chunkPos;
+                firstEdit = false;
 
-        if (game::AImodeON()) {
-        
-            if (AIagentChunks_.find(selectedAIWorld_) == AIagentChunks_.cend()) {
-            
-                AIagentChunks_[selectedAIWorld_] = std::unordered_map<vec3, chunk*>(); // Store here differences between the original level and the agent's copy.
-                AIChunkAvailable_[selectedAIWorld_] = std::unordered_map<vec3, bool>(); // Store if the agent's copy chunk can be accessed.
-            
-            }
-               
-            std::unordered_map<vec3, chunk*>& agentWorld = AIagentChunks_[selectedAIWorld_];
-            if (agentWorld.find(chunkPos) == agentWorld.cend()) {
-            
-                if (chunks_.find(chunkPos) == chunks_.cend())
-                    logger::errorLog("There is no chunk " + std::to_string(chunkPos.x) + '|' + std::to_string(chunkPos.y) + '|' + std::to_string(chunkPos.z) +
-                                     "for AI agent " + std::to_string(selectedAIWorld_));
-                else {
-                    
-                    agentWorld[chunkPos] = new chunk(*chunks_[chunkPos]);
-                    AIChunkAvailable_[selectedAIWorld_][chunkPos] = true;
-                
-                }
-                
             }
-            
-            return agentWorld[chunkPos]->setBlock(getChunkRelCoords(x, y, z), blockID);
-        
+
+            if (session)
+                session->setBlock(getChunkRelCoords(it->pos), it->blockID);
+
         }
-        else {
-        
-            if (chunks_.find(chunkPos) == chunks_.cend())
-                logger::errorLog("Chunk " + std::to_string(chunkPos.x) + "|" + std::to_string(chunkPos.y) + "|" + std::to_string(chunkPos.z) + " does not exist");
-            else {
-            
-                block removedBlock = chunks_[chunkPos]->setBlock(getChunkRelCoords(x, y, z), blockID);
 
-                chunkManager::highPriorityUpdate(chunkPos);
+        if (session) {
+
+            session.reset();
+
+            if (!game::AImodeON())
+                chunkManager::highPriorityUpdate(lastChunkPos);
 
-                return removedBlock;
-            
-            }
-                 
         }
 
     }
 
     chunk* chunkManager::createChunkAt(bool empty, const vec3& chunkPos) {
 
-        std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
-
-        if (chunks_.find(chunkPos) == chunks_.end())
+        if (!findChunk_(chunkPos))
             return createChunk(empty, chunkPos);
         else
             logger::errorLog("Chunk at " + std::to_string(chunkPos.x) + '|' + std::to_string(chunkPos.y) + '|' + std::to_string(chunkPos.z) + " already exists");
@@ -685,21 +2135,17 @@ namespace VoxelEng {
 
     chunk* chunkManager::createChunk(bool empty, const vec3& chunkPos) {
 
-        std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
-
-        chunk* selectedChunk = nullptr;
-        if (chunks_.find(chunkPos) == chunks_.cend()) {
+        chunkReadGuard guard; // A chunk found here cannot be reused while it is regenerated.
+        chunk* selectedChunk = findChunk_(chunkPos);
+        if (!selectedChunk) {
 
-            selectedChunk = new chunk(empty, chunkPos);
-            chunks_.insert_or_assign(chunkPos, selectedChunk);
+            // The chunk is generated outside the chunks dictionary's lock. If another
+            // thread registers a chunk at the same position first, that one is used instead.
+            selectedChunk = registerChunk_(chunkPos, chunkPool::acquire(empty, chunkPos));
 
         }
-        else {
-        
-            selectedChunk = chunks_[chunkPos];
+        else
             selectedChunk->regenChunk(empty, chunkPos);
-        
-        }
 
         return selectedChunk;
 
@@ -707,37 +2153,21 @@ namespace VoxelEng {
 
     chunk* chunkManager::selectChunk(int x, int y, int z) {
 
-        vec3 chunkPos(x, y, z);
-        std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
-        
-        if (chunks_.find(chunkPos) != chunks_.end())
-            return chunks_.at(chunkPos);
-        else
-            return nullptr;
+        return findChunk_(vec3(x, y, z));
         
     }
 
     chunk* chunkManager::selectChunkByChunkPos(const vec3& chunkPos) {
 
-        std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
-
-        if (chunks_.find(chunkPos) != chunks_.end())
-            return chunks_.at(chunkPos);
-        else
-            return nullptr;
+        return findChunk_(chunkPos);
 
     }
 
     chunk* chunkManager::selectChunkByChunkPos(int x, int y, int z) {
 
         vec3 chunkPos = getChunkCoords(x, y, z);
-        std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
 
-
-        if (chunks_.find(chunkPos) != chunks_.end())
-            return chunks_.at(chunkPos);
-        else
-            return nullptr;
+        return findChunk_(chunkPos);
 
     }
 
@@ -745,97 +2175,43 @@ namespace VoxelEng {
 
         vec3 chunkPos = getChunkCoords(pos);
 
-
-        std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
-
-        if (chunks_.find(chunkPos) != chunks_.end())
-            return chunks_.at(chunkPos);
-        else
-            return nullptr;
+        return findChunk_(chunkPos);
 
     }
 
     chunk* chunkManager::neighborMinusX(const vec3& chunkPos) {
 
-        vec3 neighborChunkPos(chunkPos.x - 1, chunkPos.y, chunkPos.z);
-
-
-        std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
-
-        if (chunks_.find(neighborChunkPos) != chunks_.end())
-            return chunks_.at(neighborChunkPos);
-        else
-            return nullptr;
+        return neighbor_(chunkPos, blockViewDir::NEGX);
 
     }
 
     chunk* chunkManager::neighborPlusX(const vec3& chunkPos) {
 
-        vec3 neighborChunkPos(chunkPos.x + 1, chunkPos.y, chunkPos.z);
-
-
-        std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
-
-        if (chunks_.find(neighborChunkPos) != chunks_.end())
-            return chunks_.at(neighborChunkPos);
-        else
-            return nullptr;
+        return neighbor_(chunkPos, blockViewDir::PLUSX);
 
     }
 
     chunk* chunkManager::neighborMinusY(const vec3& chunkPos) {
 
-        vec3 neighborChunkPos(chunkPos.x, chunkPos.y - 1, chunkPos.z);
-
-
-        std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
-
-        if (chunks_.find(neighborChunkPos) != chunks_.end())
-            return chunks_.at(neighborChunkPos);
-        else
-            return nullptr;
+        return neighbor_(chunkPos, blockViewDir::NEGY);
 
     }
 
     chunk* chunkManager::neighborPlusY(const vec3& chunkPos) {
 
-        vec3 neighborChunkPos(chunkPos.x, chunkPos.y + 1, chunkPos.z);
-
-
-        std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
-
-        if (chunks_.find(neighborChunkPos) != chunks_.end())
-            return chunks_.at(neighborChunkPos);
-        else
-            return nullptr;
+        return neighbor_(chunkPos, blockViewDir::PLUSY);
 
     }
 
     chunk* chunkManager::neighborMinusZ(const vec3& chunkPos) {
 
-        vec3 neighborChunkPos(chunkPos.x, chunkPos.y, chunkPos.z - 1);
-
-
-        std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
-
-        if (chunks_.find(neighborChunkPos) != chunks_.end())
-            return chunks_.at(neighborChunkPos);
-        else
-            return nullptr;
+        return neighbor_(chunkPos, blockViewDir::NEGZ);
 
     }
 
     chunk* chunkManager::neighborPlusZ(const vec3& chunkPos) {
 
-        vec3 neighborChunkPos(chunkPos.x, chunkPos.y, chunkPos.z + 1);
-
-
-        std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
-
-        if (chunks_.find(neighborChunkPos) != chunks_.end())
-            return chunks_.at(neighborChunkPos);
-        else
-            return nullptr;
+        return neighbor_(chunkPos, blockViewDir::PLUSZ);
 
     }
 
@@ -855,78 +2231,69 @@ namespace VoxelEng {
 
         std::unique_lock<std::recursive_mutex> lock(drawableChunksWriteMutex_);
 
-        drawableChunksWrite_->insert_or_assign(renderingData.chunkPos, renderingData.vertices);
+        drawableChunksWrite_->insert_or_assign(renderingData.chunkPos, renderingData.mesh);
 
     }
 
-    void chunkManager::swapDrawableChunksLists() {
+    void chunkManager::removeDrawableChunk(const vec3& chunkPos) {
 
-        std::unordered_map<vec3, std::vector<vertex>>* aux = drawableChunksRead_;
+        std::unique_lock<std::recursive_mutex> lock(drawableChunksWriteMutex_);
 
-        drawableChunksRead_ = drawableChunksWrite_;
-        drawableChunksWrite_ = aux;
+        drawableChunksWrite_->insert_or_assign(chunkPos, nullptr);
 
     }
 
-    void chunkManager::updatePriorityChunks() {
-
-        vec3 chunkPos;
-        while (!priorityUpdateList_.empty()) {
+    void chunkManager::updateDrawableChunks() {
 
-            chunkPos = priorityUpdateList_.front();
-
-            priorityUpdateList_.pop_front();
+        std::unique_lock<std::recursive_mutex> lock(drawableChunksWriteMutex_);
 
-            if (drawableChunksWrite_->contains(chunkPos))
-                drawableChunksRead_->insert_or_assign(chunkPos, drawableChunksWrite_->at(chunkPos));
+        for (auto it = drawableChunksWrite_->begin(); it != drawableChunksWrite_->end(); it++)
+            if (it->second)
+                drawableChunksRead_->insert_or_assign(it->first, std::move(it->second));
+            else
+                drawableChunksRead_->erase(it->first);
 
-        }
+        drawableChunksWrite_->clear();
 
     }
 
-    void chunkManager::loadChunk(const vec3& chunkPos) {
-
-        bool chunkNotLoaded;
+    void chunkManager::updatePriorityChunks() {
 
+        std::unique_lock<std::recursive_mutex> lock(drawableChunksWriteMutex_);
 
-        {
+        vec3 chunkPos;
+        while (!priorityUpdateList_.empty()) {
 
-            std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
+            chunkPos = priorityUpdateList_.front();
 
-            chunkNotLoaded = chunks_.find(chunkPos) == chunks_.end();
+            priorityUpdateList_.pop_front();
 
-        }
+            auto it = drawableChunksWrite_->find(chunkPos);
+            if (it != drawableChunksWrite_->end()) {
 
-        if (chunkNotLoaded) {
+                if (it->second)
+                    drawableChunksRead_->insert_or_assign(chunkPos, std::move(it->second));
+                else
+                    drawableChunksRead_->erase(chunkPos);
 
-            chunk* chunkPtr = nullptr;
+                drawableChunksWrite_->erase(it);
 
-            {
+            }
 
-                std::unique_lock<std::recursive_mutex> lock(freeChunksMutex_);
+        }
 
-                if (freeChunks_.size()) {
+    }
 
-                    chunkPtr = freeChunks_.front();
-                    freeChunks_.pop_front();
+    void chunkManager::loadChunk(const vec3& chunkPos) {
 
-                }
-                else
-                    chunkPtr = chunkManager::createChunk(true, vec3Zero);
+        if (!findChunk_(chunkPos)) {
 
-            }
+            chunk* chunkPtr = chunkPool::acquire(false, chunkPos);
 
             chunkPtr->changed() = true;
-            chunkPtr->chunkPos() = chunkPos;
-            worldGen::generate(*chunkPtr);
-
-            {
 
-                std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
-
-                chunks_.insert_or_assign(chunkPos, chunkPtr);
-
-            }
+            // If another thread loaded the chunk first, the chunk generated here is released instead.
+            registerChunk_(chunkPos, chunkPtr);
 
         }
 
@@ -934,279 +2301,241 @@ namespace VoxelEng {
 
     void chunkManager::unloadChunk(const vec3& chunkPos) {
 
-        std::unordered_map<vec3, chunk*>::iterator it;
-        std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
-        std::unique_lock<std::recursive_mutex> lockFree(freeChunksMutex_);
-
-        if ((it = chunks_.find(chunkPos)) != chunks_.end()) {
+        if (chunk* unloadedChunk = unregisterChunk_(chunkPos)) {
 
-            chunk* unloadedChunk = it->second;
-            chunks_.erase(chunkPos);
-            freeChunks_.push_back(unloadedChunk);
+            removeDrawableChunk(chunkPos);
+            chunkPool::release(unloadedChunk);
 
         }
 
     }
 
-    void chunkManager::meshChunks(const std::atomic<int>& chunkRange, int rangeStart, int rangeEnd,
-                                  std::shared_mutex& syncMutex, std::condition_variable_any& meshingThreadsCV,
-                                  std::atomic<bool>& meshingTsCVContinue, std::barrier<>& syncPoint) {
+    void chunkManager::manageChunks(unsigned int nMeshingThreads) {
 
         {
 
-            std::shared_lock syncLock(syncMutex);
+            std::unique_lock<std::mutex> lock(managerThreadMutex_);
 
-            vec3 playerChunkCoord,
-                 viewedChunkCoord,
-                 offset;
-            chunk* selectedChunk = nullptr;
+            // Loading, generation, meshing and unloading tasks are run by
+            // the scheduler's threads, which steal tasks from each other
+            // instead of working on a fixed part of the world.
+            taskScheduler scheduler(nMeshingThreads);
+            chunkMeshingJob job;
+            timePoint deadline;
+            chunk* priorityChunk = nullptr;
 
 
+            // Chunk management main loop.
             while (game::selectedEngineMode() == VoxelEng::engineMode::EDITLEVEL) {
 
-                // Wait for the chunk management thread's signal.
-                while (!meshingTsCVContinue)
-                    meshingThreadsCV.wait(syncLock);
-
-                playerChunkCoord = camera::cPlayerCamera()->chunkPos();
-
-                // World loading.
-                for (offset.y = rangeStart; offset.y <= rangeEnd; offset.y++)
-                    for (offset.x = -chunkRange; offset.x < chunkRange; offset.x++)
-                        for (offset.z = -chunkRange; offset.z < chunkRange; offset.z++)
-                        {
-
-                            // First check if there is any high priority chunk update.
-                            // If so, force synchronization with the
-                            // rendering thread to reflect the change made.
-                            {
-
-                                std::unique_lock<std::recursive_mutex> priorityListLock(priorityMeshingListMutex_);
-                                forceSyncFlag_ = !priorityMeshingList_.empty();
-
-                            }
+                // High priority chunk updates are processed before any other job so
+                // that they are reflected in the rendering thread as quickly as possible.
+                {
 
-                            // If a forcible synchronization was issued.
-                            if (forceSyncFlag_)
-                            {
+                    std::unique_lock<std::recursive_mutex> priorityListLock(priorityMeshingListMutex_);
+                    forceSyncFlag_ = !priorityMeshingList_.empty();
 
-                                // Sync with the other meshing threads and the chunk management thread.
-                                syncPoint.arrive_and_wait();
-                                meshingTsCVContinue = false;
+                }
 
-                                // Wait for the chunk management thread's signal.
-                                while (!meshingTsCVContinue)
-                                    meshingThreadsCV.wait(syncLock);
+                if (forceSyncFlag_) {
 
-                            }
+                    vec3 priorityChunkPos;
+                    bool synchronize = false,
+                        isLockActive = false;
 
-                            // Now continue processing common chunk updates.
-                            viewedChunkCoord = playerChunkCoord + offset;
-                            selectedChunk = selectChunkByChunkPos(viewedChunkCoord);
 
-                            if (selectedChunk) // If that chunk is loaded.
-                            {
+                    priorityMeshingListMutex_.lock();
+                    isLockActive = true;
 
-                                // Unmark as freeable.
-                                freeableChunksMutex_.lock();
-                                freeableChunks_.erase(viewedChunkCoord);
-                                freeableChunksMutex_.unlock();
+                    while (!priorityMeshingList_.empty()) {
 
-                                // Regenerate mesh and push for rendering if necessary. 
-                                if (selectedChunk->getNBlocks())
-                                {
+                        priorityChunkPos = priorityMeshingList_.front();
+                        priorityMeshingList_.pop_front();
 
-                                    if (selectedChunk->changed())
-                                    {
+                        priorityMeshingListMutex_.unlock();
+                        isLockActive = false;
 
-                                        selectedChunk->changed() = false;
-                                        selectedChunk->renewMesh();
+                        chunkReadGuard guard;
+                        priorityChunk = selectChunkByChunkPos(priorityChunkPos);
 
-                                    }
+                        if (priorityChunk) {
 
-                                    pushDrawableChunks(selectedChunk->renderingData());
+                            synchronize = true;
 
-                                }
+                            // Update mesh. 
+                            priorityChunk->changed() = false;
+                            priorityChunk->renewMesh();
 
-                            }
-                            else
-                                loadChunk(viewedChunkCoord);
+                            pushDrawableChunks(priorityChunk->renderingData());
+                            priorityUpdateList_.push_back(priorityChunk->chunkPos());
 
                         }
 
-                // Sync with the other meshing threads and the chunk management thread.
-                syncPoint.arrive_and_wait();
-                meshingTsCVContinue = false;
-
-            }
-
-        }
-
-        // Finish procedure.
-        syncPoint.arrive_and_drop();
-
-    }
+                        priorityMeshingListMutex_.lock();
+                        isLockActive = true;
 
-    void chunkManager::manageChunks(unsigned int nMeshingThreads) {
+                    }
 
-        std::vector<std::thread> meshingThreads;
+                    if (isLockActive)
+                        priorityMeshingListMutex_.unlock();
 
+                    // Sync with the rendering thread if necessary.
+                    if (synchronize)
+                        managerThreadCV_.wait(lock);
 
-        {
+                    // Reset the forcible synchronization flag.
+                    forceSyncFlag_ = false;
 
-            std::unique_lock<std::mutex> lock(managerThreadMutex_);
+                }
 
-            // The total number of chunks rendered in the Y-axis.
-            // This value is different from the values in the
-            // other axes to prevent slow chunk loading while
-            // maintaining a good render distance range.
-            int rangeStart,
-                rangeEnd;
-            std::atomic<int> chunkRange = 0;
-            std::atomic<bool> meshingTsCVContinue = false;
-            std::shared_mutex syncMutex;
-            std::condition_variable_any meshingThreadsCV;
-            std::barrier syncPoint(nMeshingThreads + 1);
-            chunk* priorityChunk = nullptr;
+                {
 
+                    // Marks all chunks as freeable
+                    std::shared_lock<std::shared_mutex> chunksLock(chunksMutex_);
+                    for (std::unordered_map<vec3, chunk*>::const_iterator it = chunks().cbegin(); it != chunks().cend(); it++)
+                        freeableChunks_.insert(it->first);
 
-            // Initialize meshing threads.
-            for (unsigned int i = 0; i < nMeshingThreads; i++) {
+                }
 
-                rangeStart = totalYChunks / nMeshingThreads * i;
-                if (i == nMeshingThreads - 1)
-                    rangeEnd = totalYChunks;
-                else
-                    rangeEnd = rangeStart + totalYChunks / nMeshingThreads - 1;
+                // Queue this iteration's jobs, unmarking the chunks within range as freeable.
+                queueMeshingJobs_();
+
+                // Submit the jobs in order of priority and wait for them to finish.
+                // Jobs left unfinished are queued again in the next iteration
+                // with their priorities updated to the player's new position.
+                deadline = std::chrono::high_resolution_clock::now() + CHUNK_MESHING_TIME_BUDGET;
+                while (popMeshingJob_(job))
+                    scheduler.submit([job, deadline]() { runMeshingJob_(job, deadline); });
+                scheduler.wait();
+
+                // All remaining chunks marked as freeable are freed now that no
+                // task can access them. Each unload only locks the chunks dictionary
+                // while the chunk is being unregistered.
+                for (std::unordered_set<vec3>::iterator it = freeableChunks_.begin(); it != freeableChunks_.end(); it++)
+                    scheduler.submit([chunkPos = *it]() { unloadChunk(chunkPos); });
+                scheduler.wait();
+
+                // Sync with the rendering thread.
+                managerThreadCV_.wait(lock);
 
-                meshingThreads.push_back(std::thread(&chunkManager::meshChunks,
-                                         ref(chunkRange), rangeStart - yChunksRange, rangeEnd - yChunksRange,
-                                         ref(syncMutex), ref(meshingThreadsCV),
-                                         ref(meshingTsCVContinue), ref(syncPoint)));
+                // Reset some data structures for the next iteration.
+                freeableChunks_.clear();
+                chunkReclaimer::reclaim();
 
             }
 
-            // Chunk management main loop.
-            while (game::selectedEngineMode() == VoxelEng::engineMode::EDITLEVEL) {
-
-                // This will only execute when a high priority chunk update
-                // is not issued.
-                if (!forceSyncFlag_) {
-
-                    // Marks all chunks as freeable
-                    for (std::unordered_map<vec3, chunk*>::const_iterator it = chunks().cbegin(); it != chunks().cend(); it++)
-                        freeableChunks_.insert(it->first);
+            drawableChunksRead_->clear();
+            drawableChunksWrite_->clear();
 
-                }
-                else // Reset the forcible synchronization flag.
-                    forceSyncFlag_ = false;
+        }
 
-                // Signal all meshing threads to begin.
-                meshingTsCVContinue = true;
-                meshingThreadsCV.notify_all();
+    }
 
-                // Wait for all meshing threads to finish.
-                syncPoint.arrive_and_wait();
+    void chunkManager::queueMeshingJobs_() {
 
+        const camera* playerCamera = camera::cPlayerCamera();
+        vec3 playerChunkPos = playerCamera->chunkPos(),
+             cameraPos = playerCamera->pos(),
+             cameraDir = playerCamera->direction(),
+             chunkPos,
+             toChunk;
+        chunk* selectedChunk = nullptr;
+        unsigned int lod = 0;
+        float distance = 0,
+              ringDistance = 0,
+              chunkRadius = std::sqrt(3.0f) * SCX / 2,
+              cosFOV = std::cos(glm::radians(std::min(playerCamera->FOV(), 90.0f)));
+        bool hasDirection = glm::length(cameraDir) > 0;
 
-                // This will only execute when a high priority chunk update
-                // is not issued.
-                // This prevents unloading chunks that are within the player's view range
-                // and that didn't get viewed because search stopped because
-                // a high priority chunk update was issued. It also prevents
-                if (!forceSyncFlag_) {
+        if (hasDirection)
+            cameraDir = glm::normalize(cameraDir);
 
-                    // All remaining chunks marked as freeable are freed.
-                    // No thread can access the chunks dictionary  
-                    // at the same time this is being executed.
-                    chunksMutex_.lock();
-                    for (std::unordered_set<vec3>::iterator it = freeableChunks_.begin(); it != freeableChunks_.end(); it++)
-                        unloadChunk(*it);
-                    chunksMutex_.unlock();
+        std::unique_lock<std::mutex> jobsLock(meshingJobsMutex_);
+        std::unique_lock<std::mutex> freeableLock(freeableChunksMutex_);
 
-                    // Increase chunk viewing range for the next
-                    // iteration until we reach the limit established
-                    // by the player's configuration.
-                    if (chunkRange <= nChunksToCompute_)
-                        chunkRange++;
+        for (chunkPos.y = -yChunksRange; chunkPos.y <= yChunksRange; chunkPos.y++)
+            for (chunkPos.x = playerChunkPos.x - nChunksToCompute_; chunkPos.x < playerChunkPos.x + nChunksToCompute_; chunkPos.x++)
+                for (chunkPos.z = playerChunkPos.z - nChunksToCompute_; chunkPos.z < playerChunkPos.z + nChunksToCompute_; chunkPos.z++) {
 
-                    // Sync with the rendering thread.
-                    managerThreadCV_.wait(lock);
+                    selectedChunk = selectChunkByChunkPos(chunkPos);
 
-                    // Reset some data structures for the next iteration.
-                    freeableChunks_.clear();
-                    drawableChunksWrite_->clear();
+                    if (selectedChunk) {
 
-                }
-                else { // If there is a high priority chunk update, process it.
+                        freeableChunks_.erase(chunkPos);
 
-                    vec3 priorityChunkPos;
-                    bool synchronize = false,
-                        isLockActive = false;
+                        // The chunk's level of detail is given by the distance ring around the player it is in.
+                        ringDistance = std::max({ std::abs(chunkPos.x - playerChunkPos.x),
+                                                  std::abs(chunkPos.y - playerChunkPos.y),
+                                                  std::abs(chunkPos.z - playerChunkPos.z) });
+                        lod = 0;
+                        while (lod + 1 < CHUNK_N_LODS && ringDistance >= lodDistances_[lod + 1])
+                            lod++;
+                        setChunkLOD_(selectedChunk, lod);
 
+                        if (!selectedChunk->changed())
+                            continue;
 
-                    priorityMeshingListMutex_.lock();
-                    isLockActive = true;
+                    }
 
-                    while (!priorityMeshingList_.empty()) {
+                    // The chunk's bounding sphere is tested against a cone around the camera's direction
+                    // whose half-angle is the camera's vertical FOV, which covers the horizontal FOV too
+                    // for the usual aspect ratios.
+                    toChunk = vec3(chunkPos.x * SCX, chunkPos.y * SCY, chunkPos.z * SCZ) + vec3(SCX / 2.0f) - cameraPos;
+                    distance = glm::length(toChunk);
+                    if (hasDirection && distance > chunkRadius && glm::dot(toChunk, cameraDir) < cosFOV * distance - chunkRadius)
+                        distance *= CHUNK_OUT_OF_VIEW_PRIORITY;
 
-                        priorityChunkPos = priorityMeshingList_.front();
-                        priorityMeshingList_.pop_front();
+                    meshingJobs_.push({ chunkPos, distance });
 
-                        priorityMeshingListMutex_.unlock();
-                        isLockActive = false;
+                }
 
-                        priorityChunk = selectChunkByChunkPos(priorityChunkPos);
+    }
 
-                        if (priorityChunk) {
+    void chunkManager::runMeshingJob_(const chunkMeshingJob& job, const timePoint& deadline) {
 
-                            synchronize = true;
+        // Skip the job if it ran out of time or if a high priority chunk update
+        // was issued, so that the chunk management thread can process it.
+        if (std::chrono::high_resolution_clock::now() >= deadline)
+            return;
 
-                            // Unmark as freeable.
-                            freeableChunksMutex_.lock();
-                            freeableChunks_.erase(priorityChunk->chunkPos());
-                            freeableChunksMutex_.unlock();
+        {
 
-                            // Update mesh. 
-                            priorityChunk->changed() = false;
-                            priorityChunk->renewMesh();
+            std::unique_lock<std::recursive_mutex> priorityListLock(priorityMeshingListMutex_);
+            if (!priorityMeshingList_.empty())
+                return;
 
-                            pushDrawableChunks(priorityChunk->renderingData());
-                            priorityUpdateList_.push_back(priorityChunk->chunkPos());
+        }
 
-                        }
+        chunkReadGuard guard;
+        if (chunk* selectedChunk = selectChunkByChunkPos(job.chunkPos)) {
 
-                        priorityMeshingListMutex_.lock();
-                        isLockActive = true;
+            // Regenerate mesh and push for rendering if necessary.
+            if (selectedChunk->changed()) {
 
-                    }
+                selectedChunk->changed() = false;
+                selectedChunk->renewMesh();
 
-                    if (isLockActive)
-                        priorityMeshingListMutex_.unlock();
+                pushDrawableChunks(selectedChunk->renderingData());
 
-                    // Sync with the rendering thread if necessary.
-                    if (synchronize)
-                        managerThreadCV_.wait(lock);
+            }
 
-                }
+        }
+        else
+            loadChunk(job.chunkPos);
 
+    }
 
-            }
+    bool chunkManager::popMeshingJob_(chunkMeshingJob& job) {
 
-            // Finish procedure.
-            // First unblock any meshing thread so they can finish their execution properly.
-            syncPoint.arrive_and_drop();
-            meshingTsCVContinue = true;
-            meshingThreadsCV.notify_all();
+        std::unique_lock<std::mutex> lock(meshingJobsMutex_);
 
-            // Now wait for all meshing threads to end.
-            for (unsigned int i = 0; i < nMeshingThreads; i++)
-                meshingThreads[i].join();
+        if (meshingJobs_.empty())
+            return false;
 
-            drawableChunksRead_->clear();
-            drawableChunksWrite_->clear();
+        job = meshingJobs_.top();
+        meshingJobs_.pop();
 
-        }
+        return true;
 
     }
 
@@ -1226,9 +2555,6 @@ namespace VoxelEng {
                 */
                 if (terrainFile.empty()) {
 
-                    std::unique_lock<std::recursive_mutex> lock(chunksMutex_);
-
-
                     if (unsigned int slot = game::selectedSaveSlot())
                         loadAllChunks("saves/slot" + std::to_string(slot) + "/level");
                     else {
@@ -1243,7 +2569,7 @@ namespace VoxelEng {
                                 for (chunkPos.z = -nChunksToCompute_; chunkPos.z < nChunksToCompute_; chunkPos.z++) {
 
                                     selectedChunk = chunkManager::createChunk(false, chunkPos);
-                                    chunks_.insert_or_assign(chunkPos, selectedChunk);
+                                    registerChunk_(chunkPos, selectedChunk);
 
                                 }
 
@@ -1272,7 +2598,7 @@ namespace VoxelEng {
                             selectedChunk->renewMesh();
                             selectedChunk->changed() = false;
 
-                            if (selectedChunk->renderingData().vertices.size())
+                            if (selectedChunk->renderingData().mesh)
                                 pushDrawableChunks(selectedChunk->renderingData());
 
                         }
@@ -1371,7 +2697,7 @@ namespace VoxelEng {
 
 
                             selectedChunk = chunkManager::createChunk(false, chunkPos);
-                            chunks_.insert_or_assign(chunkPos, selectedChunk);
+                            registerChunk_(chunkPos, selectedChunk);
 
                         }
 
@@ -1391,6 +2717,7 @@ namespace VoxelEng {
     void chunkManager::saveAllChunks(const std::string& path) {
 
         std::unique_lock<std::recursive_mutex> lock(input::inputMutex());
+        std::shared_lock<std::shared_mutex> chunksLock(chunksMutex_);
         input::shouldProcessInputs(false);
 
         // Save chunk data.
@@ -1418,6 +2745,13 @@ namespace VoxelEng {
             
                 saveData += std::to_string((int)it->first.x) + '|' + std::to_string((int)it->first.y) + '|' + std::to_string((int)it->first.z) + "|@";
                 
+                if (it->second->uniform()) {
+
+                    saveData += std::to_string(it->second->getBlock(0, 0, 0)) + ':' + std::to_string(N_CHUNK_BLOCKS) + "|@";
+                    continue;
+
+                }
+
                 readFirstBlock = false;
                 sameBlockCounter = 0;
                 for (int x = 0; x < SCX; x++)
@@ -1513,13 +2847,14 @@ namespace VoxelEng {
                         case 0: // Set number of chunks to compute and load chunk data structures.
 
                             nChunksToCompute_ = number;
+                            reserveChunkPool_();
 
                             for (pos.y = -yChunksRange; pos.y < yChunksRange; pos.y++)
                                 for (pos.x = -nChunksToCompute_; pos.x < nChunksToCompute_; pos.x++)
                                     for (pos.z = -nChunksToCompute_; pos.z < nChunksToCompute_; pos.z++) {
 
                                         selectedChunk = chunkManager::createChunk(true, pos);
-                                        chunks_.insert_or_assign(pos, selectedChunk);
+                                        registerChunk_(pos, selectedChunk);
 
                                     }
 
@@ -1589,8 +2924,15 @@ namespace VoxelEng {
 
                         case 4: // Placing blocks in the currently selected chunk.
 
-                            for (int i = 0; i < number; i++)
-                                selectedChunk->setBlock(chunkLinearIndex++, blockID);
+                            if (chunkLinearIndex == 0 && number == N_CHUNK_BLOCKS) {
+
+                                selectedChunk->makeUniform(blockID);
+                                chunkLinearIndex = N_CHUNK_BLOCKS;
+
+                            }
+                            else // Blocks are saved in row-major order, which may not be the chunk's block order.
+                                for (int i = 0; i < number; i++, chunkLinearIndex++)
+                                    selectedChunk->setBlock(chunkLinearIndex / (SCY * SCZ), chunkLinearIndex / SCZ % SCY, chunkLinearIndex % SCZ, blockID);
 
                             parseState--;
 
@@ -1623,11 +2965,17 @@ namespace VoxelEng {
 
             }
 
-            // Lastly, mark all chunks as decorated as the entire level has been properly loaded.
+            // Lastly, mark all chunks as decorated as the entire level has been properly loaded
+            // and store the chunks that contain only one type of block as uniform chunks.
             for (pos.y = -yChunksRange; pos.y < yChunksRange; pos.y++)
                 for (pos.x = -nChunksToCompute_; pos.x < nChunksToCompute_; pos.x++)
-                    for (pos.z = -nChunksToCompute_; pos.z < nChunksToCompute_; pos.z++)
-                        selectChunkByChunkPos(pos)->setLoadLevel(VoxelEng::chunkLoadLevel::DECORATED);
+                    for (pos.z = -nChunksToCompute_; pos.z < nChunksToCompute_; pos.z++) {
+
+                        selectedChunk = selectChunkByChunkPos(pos);
+                        selectedChunk->compact();
+                        selectedChunk->setLoadLevel(VoxelEng::chunkLoadLevel::DECORATED);
+
+                    }
 
             t.finish();
             logger::debugLog("Time: " + std::to_string(t.getDurationMs()) + " ms");
@@ -1676,6 +3024,7 @@ namespace VoxelEng {
     void chunkManager::resetAIChunks() {
     
         timer t;
+        std::unique_lock<std::shared_mutex> lock(AIChunksMutex_);
 
         t.start();
         for (auto it = AIChunkAvailable_.begin(); it != AIChunkAvailable_.end(); it++)
@@ -1698,9 +3047,17 @@ namespace VoxelEng {
 
     void chunkManager::clean() {
 
+        std::unique_lock<std::shared_mutex> chunksLock(chunksMutex_);
+        std::unique_lock<std::shared_mutex> AIChunksLock(AIChunksMutex_);
+
+        clearChunkGrid_();
         for (auto it = chunks_.begin(); it != chunks_.end(); it++)
-            if (it->second)
-                delete it->second;
+            if (it->second) {
+
+                unlinkNeighbors_(it->second);
+                chunkPool::release(it->second);
+
+            }
         chunks_.clear();
 
         if (drawableChunksRead_)
@@ -1709,11 +3066,6 @@ namespace VoxelEng {
         if (drawableChunksWrite_)
             drawableChunksWrite_->clear();
 
-        for (auto it = freeChunks_.cbegin(); it != freeChunks_.cend(); it++)
-            if (*it)
-                delete* it;
-        freeChunks_.clear();
-
         freeableChunks_.clear();
 
         priorityMeshingList_.clear();
@@ -1721,18 +3073,26 @@ namespace VoxelEng {
 
         for (auto it = AIagentChunks_.cbegin(); it != AIagentChunks_.cend(); it++)
             for (auto itChunks = it->second.cbegin(); itChunks != it->second.cend(); itChunks++)
-                delete itChunks->second;
+                chunkPool::release(itChunks->second);
         AIagentChunks_.clear();
+        AIChunkAvailable_.clear();
 
     }
 
     void chunkManager::cleanUp() {
 
-        for (auto it = chunks_.begin(); it != chunks_.end(); it++)
-            if (it->second)
-                delete it->second;
+        std::unique_lock<std::shared_mutex> chunksLock(chunksMutex_);
+        std::unique_lock<std::shared_mutex> AIChunksLock(AIChunksMutex_);
+
+        clearChunkGrid_();
         chunks_.clear();
 
+        delete chunkGrid_.load();
+        chunkGrid_ = nullptr;
+        for (auto it = retiredChunkGrids_.cbegin(); it != retiredChunkGrids_.cend(); it++)
+            delete* it;
+        retiredChunkGrids_.clear();
+
         if (drawableChunksRead_) {
         
             delete drawableChunksRead_;
@@ -1747,34 +3107,383 @@ namespace VoxelEng {
 
         }
 
-        for (auto it = freeChunks_.cbegin(); it != freeChunks_.cend(); it++)
-            if (*it)
-                delete* it;
-        freeChunks_.clear();
-
         freeableChunks_.clear();
 
         priorityMeshingList_.clear();
         priorityUpdateList_.clear();
 
-        for (auto it = AIagentChunks_.cbegin(); it != AIagentChunks_.cend(); it++)
-            for (auto itChunks = it->second.cbegin(); itChunks != it->second.cend(); itChunks++)
-                delete itChunks->second;
         AIagentChunks_.clear();
+        AIChunkAvailable_.clear();
+
+        chunkPool::cleanUp();
+        chunkReclaimer::cleanUp();
 
         initialised_ = false;
 
     }
 
+    chunk* chunkManager::selectChunkForRead_(const vec3& chunkPos) {
+
+        if (game::AImodeON() && !originalWorldAccess_) {
+
+            auto itAgent = AIagentChunks_.find(selectedAIWorld_);
+            if (itAgent != AIagentChunks_.cend()) {
+
+                auto it = itAgent->second.find(chunkPos);
+                if (it != itAgent->second.cend() && AIChunkAvailable_.at(selectedAIWorld_).at(chunkPos))
+                    return it->second;
+
+            }
+
+        }
+
+        return findChunk_(chunkPos);
+
+    }
+
+    chunk* chunkManager::selectChunkForWrite_(const vec3& chunkPos) {
+
+        if (game::AImodeON()) {
+
+            if (AIagentChunks_.find(selectedAIWorld_) == AIagentChunks_.cend()) {
+
+                AIagentChunks_[selectedAIWorld_] = std::unordered_map<vec3, chunk*>(); // Store here differences between the original level and the agent's copy.
+                AIChunkAvailable_[selectedAIWorld_] = std::unordered_map<vec3, bool>(); // Store if the agent's copy chunk can be accessed.
+
+            }
+
+            std::unordered_map<vec3, chunk*>& agentWorld = AIagentChunks_[selectedAIWorld_];
+            auto it = agentWorld.find(chunkPos);
+            if (it == agentWorld.cend() || !AIChunkAvailable_[selectedAIWorld_][chunkPos]) {
+
+                chunk* originalChunk = findChunk_(chunkPos);
+                if (!originalChunk) {
+
+                    logger::errorLog("There is no chunk " + std::to_string(chunkPos.x) + '|' + std::to_string(chunkPos.y) + '|' + std::to_string(chunkPos.z) +
+                                     "for AI agent " + std::to_string(selectedAIWorld_));
+                    return nullptr;
+
+                }
+                else if (it == agentWorld.cend())
+                    it = agentWorld.insert_or_assign(chunkPos, chunkPool::acquire(*originalChunk)).first;
+                else { // The agent's copy was reset, so it is refreshed with the original chunk's blocks instead of being reallocated.
+
+                    std::unique_lock<std::shared_mutex> copyLock(it->second->blocksMutex_);
+                    std::shared_lock<std::shared_mutex> originalLock(originalChunk->blocksMutex_);
+
+                    it->second->beginBlockDataWrite_();
+                    it->second->copyBlocks_(*originalChunk);
+                    it->second->endBlockDataWrite_();
+
+                }
+
+                AIChunkAvailable_[selectedAIWorld_][chunkPos] = true;
+
+            }
+
+            return it->second;
+
+        }
+        else {
+
+            chunk* selectedChunk = findChunk_(chunkPos);
+
+            if (!selectedChunk)
+                logger::errorLog("Chunk " + std::to_string(chunkPos.x) + "|" + std::to_string(chunkPos.y) + "|" + std::to_string(chunkPos.z) + " does not exist");
+
+            return selectedChunk;
+
+        }
+
+    }
+
     block chunkManager::getBlockOGWorld_(int posX, int posY, int posZ) {
     
         vec3 chunkPos = getChunkCoords(posX, posY, posZ);
+        chunk* selectedChunk = findChunk_(chunkPos);
 
-        if (chunks_.find(chunkPos) == chunks_.end())
+        if (!selectedChunk)
             logger::errorLog("Chunk " + std::to_string(chunkPos.x) + "|" + std::to_string(chunkPos.y) + "|" + std::to_string(chunkPos.z) + " does not exist");
         else
-            return chunks_[chunkPos]->getBlock(floorMod(posX, SCX), floorMod(posY, SCY), floorMod(posZ, SCZ));
+            return selectedChunk->readBlockUnguarded_(chunk::linearIndex_(floorMod(posX, SCX), floorMod(posY, SCY), floorMod(posZ, SCZ)));
     
     }
 
+    int chunkManager::chunkGridSlot_(const chunkGrid* grid, const vec3& chunkPos) {
+
+        int y = (int)chunkPos.y + yChunksRange;
+
+        if (!grid || y < 0 || y >= totalYChunks)
+            return -1;
+        else
+            return (floorMod(chunkPos.x, grid->width) * totalYChunks + y) * grid->width + floorMod(chunkPos.z, grid->width);
+
+    }
+
+    chunk* chunkManager::findChunk_(const vec3& chunkPos) {
+
+        chunkGrid* grid = chunkGrid_.load(std::memory_order_acquire);
+        int slot = chunkGridSlot_(grid, chunkPos);
+
+        if (slot != -1) {
+
+            chunk* selectedChunk = grid->slots[slot].load(std::memory_order_acquire);
+
+            if (selectedChunk && selectedChunk->chunkPos() == chunkPos)
+                return selectedChunk;
+            else if (!nOutOfGridChunks_)
+                return nullptr;
+
+        }
+
+
+        // The chunk can only be in the chunks dictionary.
+        std::shared_lock<std::shared_mutex> lock(chunksMutex_);
+
+        auto it = chunks_.find(chunkPos);
+        return (it == chunks_.cend()) ? nullptr : it->second;
+
+    }
+
+    chunk* chunkManager::lookUpChunk_(const vec3& chunkPos) {
+
+        chunkGrid* grid = chunkGrid_.load(std::memory_order_acquire);
+        int slot = chunkGridSlot_(grid, chunkPos);
+
+        if (slot != -1) {
+
+            chunk* selectedChunk = grid->slots[slot].load(std::memory_order_acquire);
+
+            if (selectedChunk && selectedChunk->chunkPos() == chunkPos)
+                return selectedChunk;
+            else if (!nOutOfGridChunks_)
+                return nullptr;
+
+        }
+
+        auto it = chunks_.find(chunkPos);
+        return (it == chunks_.cend()) ? nullptr : it->second;
+
+    }
+
+    chunk* chunkManager::neighbor_(const vec3& chunkPos, blockViewDir direction) {
+
+        chunk* selectedChunk = findChunk_(chunkPos);
+
+        return (selectedChunk) ? selectedChunk->neighbor(direction) : findChunk_(chunkPos + uDirectionToVec3(direction));
+
+    }
+
+    void chunkManager::linkNeighbors_(chunk* selectedChunk) {
+
+        blockViewDir direction;
+        chunk* neighborChunk = nullptr;
+        for (int i = 0; i < 6; i++) {
+
+            direction = static_cast<blockViewDir>(i + 1);
+            neighborChunk = lookUpChunk_(selectedChunk->chunkPos() + uDirectionToVec3(direction));
+
+            selectedChunk->neighbors_[i].store(neighborChunk, std::memory_order_release);
+            selectedChunk->dirtySections_.fetch_or(chunk::borderSections_(direction));
+            if (neighborChunk) {
+
+                neighborChunk->neighbors_[static_cast<int>(inverseUDirection(direction)) - 1].store(selectedChunk, std::memory_order_release);
+                neighborChunk->dirtySections_.fetch_or(chunk::borderSections_(inverseUDirection(direction)));
+
+            }
+
+        }
+
+    }
+
+    void chunkManager::setChunkLOD_(chunk* selectedChunk, unsigned int lod) {
+
+        if (selectedChunk->lod_.exchange(lod) != lod) {
+
+            selectedChunk->dirtySections_.fetch_or(CHUNK_ALL_SECTIONS);
+            selectedChunk->changed_ = true;
+
+            // The neighbors' borders with the chunk change with its level of detail (see chunk::renewMesh).
+            chunk* neighborChunk = nullptr;
+            for (int i = 0; i < 6; i++) {
+
+                neighborChunk = selectedChunk->neighbors_[i].load(std::memory_order_acquire);
+                if (neighborChunk) {
+
+                    neighborChunk->dirtySections_.fetch_or(chunk::borderSections_(inverseUDirection(static_cast<blockViewDir>(i + 1))));
+                    neighborChunk->changed_ = true;
+
+                }
+
+            }
+
+        }
+
+    }
+
+    void chunkManager::unlinkNeighbors_(chunk* selectedChunk) {
+
+        chunk* neighborChunk = nullptr;
+        for (int i = 0; i < 6; i++) {
+
+            neighborChunk = selectedChunk->neighbors_[i].exchange(nullptr);
+            if (neighborChunk) {
+
+                blockViewDir direction = inverseUDirection(static_cast<blockViewDir>(i + 1));
+                neighborChunk->neighbors_[static_cast<int>(direction) - 1].store(nullptr, std::memory_order_release);
+                neighborChunk->dirtySections_.fetch_or(chunk::borderSections_(direction));
+
+            }
+
+        }
+
+    }
+
+    chunk* chunkManager::registerChunk_(const vec3& chunkPos, chunk* selectedChunk) {
+
+        std::unique_lock<std::shared_mutex> lock(chunksMutex_);
+
+        // The lookup and the insertion are done under the same lock, so only one
+        // of the threads that try to register a chunk at the same position succeeds.
+        auto it = chunks_.find(chunkPos);
+        if (it != chunks_.end()) {
+
+            if (it->second != selectedChunk)
+                chunkPool::release(selectedChunk);
+
+            return it->second;
+
+        }
+
+        resizeChunkGrid_();
+
+        chunks_.insert_or_assign(chunkPos, selectedChunk);
+
+        chunkGrid* grid = chunkGrid_.load();
+        int slot = chunkGridSlot_(grid, chunkPos);
+        if (slot != -1 && !grid->slots[slot].load())
+            grid->slots[slot].store(selectedChunk, std::memory_order_release);
+        else
+            nOutOfGridChunks_++;
+
+        linkNeighbors_(selectedChunk);
+
+        return selectedChunk;
+
+    }
+
+    chunk* chunkManager::unregisterChunk_(const vec3& chunkPos) {
+
+        std::unique_lock<std::shared_mutex> lock(chunksMutex_);
+
+        return removeChunk_(chunkPos);
+
+    }
+
+    chunk* chunkManager::removeChunk_(const vec3& chunkPos) {
+
+        chunk* selectedChunk = nullptr;
+        auto it = chunks_.find(chunkPos);
+        if (it != chunks_.end()) {
+
+            selectedChunk = it->second;
+            chunks_.erase(it);
+
+            unlinkNeighbors_(selectedChunk);
+
+            chunkGrid* grid = chunkGrid_.load();
+            int slot = chunkGridSlot_(grid, chunkPos);
+            if (slot != -1 && grid->slots[slot].load() == selectedChunk) {
+
+                grid->slots[slot].store(nullptr, std::memory_order_release);
+
+                // Move into the freed slot any nearby chunk that could not be stored
+                // in the chunk grid because said slot was taken.
+                if (nOutOfGridChunks_) {
+                
+                    vec3 candidatePos;
+                    for (int i = -2; i <= 2 && !grid->slots[slot].load(); i++)
+                        for (int j = -2; j <= 2 && !grid->slots[slot].load(); j++)
+                            if (i || j) {
+                            
+                                candidatePos = vec3(chunkPos.x + i * grid->width, chunkPos.y, chunkPos.z + j * grid->width);
+
+                                auto itCandidate = chunks_.find(candidatePos);
+                                if (itCandidate != chunks_.end()) {
+                                
+                                    grid->slots[slot].store(itCandidate->second, std::memory_order_release);
+                                    nOutOfGridChunks_--;
+                                
+                                }
+                            
+                            }
+                
+                }
+
+            }
+            else
+                nOutOfGridChunks_--;
+
+        }
+
+        return selectedChunk;
+
+    }
+
+    void chunkManager::resizeChunkGrid_() {
+
+        int width = chunkGridWidth_();
+        chunkGrid* grid = chunkGrid_.load();
+
+        if (!grid || grid->width != width) {
+
+            chunkGrid* newGrid = new chunkGrid;
+            newGrid->width = width;
+            newGrid->slots = std::vector<std::atomic<chunk*>>(width * width * totalYChunks);
+
+            nOutOfGridChunks_ = 0;
+            int slot = 0;
+            for (auto it = chunks_.cbegin(); it != chunks_.cend(); it++) {
+
+                slot = chunkGridSlot_(newGrid, it->first);
+                if (slot != -1 && !newGrid->slots[slot].load())
+                    newGrid->slots[slot].store(it->second);
+                else
+                    nOutOfGridChunks_++;
+
+            }
+
+            chunkGrid_.store(newGrid, std::memory_order_release);
+
+            if (grid)
+                retiredChunkGrids_.push_back(grid);
+
+        }
+
+    }
+
+    int chunkManager::chunkGridWidth_() {
+
+        return 2 * nChunksToCompute_ + 2; // Enough to hold the maximum chunk range reached in infinite worlds.
+
+    }
+
+    void chunkManager::reserveChunkPool_() {
+
+        std::size_t width = chunkGridWidth_();
+
+        chunkPool::reserve(width * width * totalYChunks);
+
+    }
+
+    void chunkManager::clearChunkGrid_() {
+
+        if (chunkGrid* grid = chunkGrid_.load())
+            for (auto it = grid->slots.begin(); it != grid->slots.end(); it++)
+                it->store(nullptr);
+
+        nOutOfGridChunks_ = 0;
+
+    }
+
 }
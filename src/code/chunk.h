@@ -9,16 +9,23 @@
 */
 #ifndef _VOXELENG_CHUNK_
 #define _VOXELENG_CHUNK_
+#include <algorithm>
 #include <atomic>
-#include <barrier>
+#include <cstddef>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <deque>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
 #include <thread>
 #include <mutex>
+#include <memory>
+#include <new>
+#include <queue>
 #include <shared_mutex>
+#include <span>
 #include <string>
 #include <hash.hpp>
 
@@ -48,7 +55,9 @@ namespace VoxelEng {
 	/////////////////////////
 
 	class camera;
+	class chunkEditSession;
 	class chunkManager;
+	class chunkPool;
 	class worldGen;
 
 
@@ -61,22 +70,474 @@ namespace VoxelEng {
 	*/
 	enum class chunkLoadLevel { NOTLOADED = 0, BASICTERRAIN = 1, DECORATED = 2 };
 
+	/**
+	* @brief The algorithms available to generate the meshes of chunks.
+	* NAIVE emits one quad per visible block face.
+	* GREEDY merges coplanar adjacent visible faces of blocks with the same ID into larger quads
+	* whose textures are repeated across them. Faces are merged across whole chunk layers, so
+	* a block edit rebuilds every layer of the chunk that crosses one of the dirty sections.
+	*/
+	enum class chunkMeshingMode { NAIVE = 0, GREEDY = 1 };
+
+
+	//////////////
+	//Constants.//
+	//////////////
+
+	/**
+	* @brief Maximum number of bits per block that the chunk's palette-compressed
+	* block storage uses to index its palette. Chunks that require more bits
+	* fall back to storing the raw block IDs.
+	*/
+	const unsigned int CHUNK_MAX_PALETTE_BITS = 8;
+
+	/**
+	* @brief Number of bits per block used when a chunk stores raw block IDs.
+	*/
+	const unsigned int CHUNK_RAW_BLOCK_BITS = sizeof(block) * 8;
+
+	/**
+	* @brief If true, chunks store their blocks in Z-order (Morton order), so that blocks that are
+	* close to each other inside a chunk are also close in memory. Otherwise, blocks are stored in
+	* row-major order with the Z axis running first.
+	* The linear indices used by the chunk's API follow the selected order.
+	*/
+	const bool CHUNK_MORTON_LAYOUT = true;
+
+	static_assert(!CHUNK_MORTON_LAYOUT || (SCX == 16 && SCY == 16 && SCZ == 16), "The Morton chunk layout requires 16x16x16 chunks");
+
+	/**
+	* @brief Alignment in bytes of the chunk slots of the chunk pool.
+	*/
+	const std::size_t CHUNK_POOL_ALIGNMENT = 64;
+
+	/**
+	* @brief Maximum number of threads that can read chunks without locking them at the same time (see chunkReclaimer).
+	*/
+	const unsigned int CHUNK_MAX_READER_THREADS = 256;
+
+	/**
+	* @brief Number of retired block data buffers waiting to be freed after which
+	* the chunk reclaimer frees the ones that no reader can access anymore.
+	*/
+	const std::size_t CHUNK_RECLAIM_THRESHOLD = 64;
+
+	/**
+	* @brief Number of chunk slots allocated when the chunk pool runs out of them.
+	*/
+	const std::size_t CHUNK_POOL_SLAB_SIZE = 256;
+
+	/**
+	* @brief Side length in blocks of the cubic sections in which chunks are divided
+	* to track which parts of their meshes need to be rebuilt.
+	*/
+	const unsigned int CHUNK_SECTION_SIZE = 4;
+
+	/**
+	* @brief Number of chunk sections along each axis of a chunk.
+	*/
+	const unsigned int CHUNK_SECTIONS_PER_AXIS = SCX / CHUNK_SECTION_SIZE;
+
+	/**
+	* @brief Number of sections in a chunk.
+	*/
+	const unsigned int CHUNK_N_SECTIONS = CHUNK_SECTIONS_PER_AXIS * CHUNK_SECTIONS_PER_AXIS * CHUNK_SECTIONS_PER_AXIS;
+
+	/**
+	* @brief Dirty section mask with all the sections of a chunk set.
+	*/
+	const std::uint64_t CHUNK_ALL_SECTIONS = ~0ull;
+
+	/**
+	* @brief Number of face layers of a chunk, one for each face direction and slice of the chunk
+	* along that direction. Greedy meshing builds the chunk's mesh one face layer at a time.
+	*/
+	const unsigned int CHUNK_N_FACE_LAYERS = 6 * SCX;
+
+	/**
+	* @brief Side length of the copy of a chunk's blocks that meshers work with,
+	* which includes a one block border with the blocks of the neighbor chunks.
+	*/
+	const unsigned int CHUNK_PADDED_SIZE = SCX + 2;
+
+	/**
+	* @brief Number of blocks in the copy of a chunk's blocks that meshers work with.
+	*/
+	const unsigned int CHUNK_PADDED_VOLUME = CHUNK_PADDED_SIZE * CHUNK_PADDED_SIZE * CHUNK_PADDED_SIZE;
+
+	/**
+	* @brief Maximum number of faces a chunk's mesh can have, reached when its blocks
+	* are laid out like a 3D checkerboard.
+	*/
+	const unsigned int CHUNK_MAX_FACES = N_CHUNK_BLOCKS / 2 * 6;
+
+	/**
+	* @brief Number of vertices of each face of a chunk's mesh.
+	* Faces are drawn as two triangles with the indices of the chunk quad index buffer.
+	*/
+	const unsigned int CHUNK_VERTICES_PER_FACE = 4;
+
+	/**
+	* @brief Number of indices of each face of a chunk's mesh.
+	*/
+	const unsigned int CHUNK_INDICES_PER_FACE = 6;
+
+	/**
+	* @brief Maximum number of old meshes each chunk keeps to build its next meshes into.
+	* Both lists of drawable chunks can still hold an old mesh while the chunk is remeshed,
+	* so at least one more than that is needed to reuse them without allocating memory.
+	*/
+	const unsigned int CHUNK_SPARE_MESHES = 3;
+
+	/**
+	* @brief Maximum number of old meshes kept by all chunks together to build their next meshes into.
+	* Once it is reached, replaced meshes are freed instead of kept and the chunks without
+	* spare meshes allocate their next mesh, until other chunks are unloaded.
+	*/
+	const unsigned int CHUNK_MAX_SPARE_MESHES = 1024;
+
+	/**
+	* @brief Number of levels of detail of chunk meshes. At level 'lod', the chunk's blocks are
+	* downsampled to cells of 2^lod blocks along each axis before meshing them.
+	*/
+	const unsigned int CHUNK_N_LODS = 3;
+
+	/**
+	* @brief Default distance (in chunks) to the player from which chunks are meshed at each
+	* level of detail with an infinite world.
+	*/
+	const unsigned int DEF_CHUNK_LOD_DISTANCES[CHUNK_N_LODS] = { 0, 6, 12 };
+
+	/**
+	* @brief Time the meshing threads spend loading and meshing chunks with an infinite world
+	* before their results are handed to the rendering thread. Unfinished jobs are queued again
+	* in the next iteration, so the closest chunks to the player are shown first.
+	*/
+	const std::chrono::milliseconds CHUNK_MESHING_TIME_BUDGET(20);
+
+	/**
+	* @brief Factor applied to the distance to the camera of the chunks out of its view
+	* when prioritising their loading and meshing jobs.
+	*/
+	const float CHUNK_OUT_OF_VIEW_PRIORITY = 4.0f;
+
+	/**
+	* @brief Face connectivity of a chunk that can be seen through from any of its faces
+	* to any other (see 'chunkMeshData::faceConnectivity').
+	*/
+	const std::uint64_t CHUNK_ALL_FACES_CONNECTED = (1ull << 36) - 1;
+
+	static_assert(SCX == SCY && SCY == SCZ && SCX % CHUNK_SECTION_SIZE == 0, "Chunk sections must evenly divide cubic chunks");
+	static_assert(CHUNK_N_SECTIONS == 64, "Dirty chunk sections are tracked with a 64-bit mask");
+	static_assert(CHUNK_N_FACE_LAYERS >= CHUNK_N_SECTIONS, "Mesh parts are stored with room for one per face layer");
+	static_assert(SCX % (1 << (CHUNK_N_LODS - 1)) == 0, "Chunks must be evenly divided at every level of detail");
+
+
+	/////////////////////
+	//Type definitions.//
+	/////////////////////
+
+	struct chunkMeshData;
+
+	/**
+	* @brief Handle to a chunk's mesh. Meshes are shared between their chunk and the lists
+	* of drawable chunks used by the rendering thread, so they are never modified once built.
+	*/
+	typedef std::shared_ptr<chunkMeshData> chunkMesh;
+
 
 	////////////
 	//Classes.//
 	////////////
 
+	/**
+	* @brief A chunk's mesh. Each mesh built gets a different version, so the rendering thread
+	* can tell whether the mesh of a chunk has changed since the last time it was drawn.
+	* 'faceConnectivity' has its bit 6 * i + j set if the chunk's faces i and j (in the order front,
+	* back, top, bottom, right and left) are connected through its non-solid blocks, that is,
+	* if the chunk can be seen through when looking into it from face i towards face j.
+	*/
+	struct chunkMeshData {
+
+		std::vector<chunkVertex> vertices;
+		std::uint64_t version = 0,
+					  faceConnectivity = CHUNK_ALL_FACES_CONNECTED;
+
+	};
+
+
 	/**
 	* @brief Wraps up data used to render a chunk.
 	*/
 	struct chunkRenderingData {
 
 		vec3 chunkPos;
-		model vertices;
+		chunkMesh mesh;
+
+	};
+
+
+	/**
+	* @brief A single block modification inside a chunk, where the block
+	* is referred to by its linear index within the chunk.
+	*/
+	struct blockEdit {
+
+		unsigned int linearIndex;
+		block blockID;
+
+	};
+
+
+	/**
+	* @brief A single block modification, where the block is referred to by its global position.
+	*/
+	struct worldBlockEdit {
+
+		vec3 pos;
+		block blockID;
+
+	};
+
+
+	/**
+	* @brief A chunk loading or meshing job for the meshing threads. Jobs with
+	* a lower priority value are processed first.
+	*/
+	struct chunkMeshingJob {
+
+		vec3 chunkPos;
+		float priority;
+
+		/**
+		* @brief Orders jobs so that std::priority_queue yields the lowest priority value first.
+		*/
+		bool operator<(const chunkMeshingJob& job) const;
+
+	};
+
+	inline bool chunkMeshingJob::operator<(const chunkMeshingJob& job) const {
+
+		return priority > job.priority;
+
+	}
+
+
+	/**
+	* @brief Describes the layout of a chunk's block data at a given moment so that
+	* readers can access it without locking the chunk's block data mutex.
+	* The palette and block words buffers it points to are only freed once no
+	* reader can hold the description anymore (see chunkReclaimer).
+	*/
+	struct chunkBlockStorageView {
+
+		unsigned int bitsPerBlock;
+		const block* palette;
+		const std::uint64_t* words;
 
 	};
 
 
+	/**
+	* @brief Epoch-based reclamation of the memory that threads reading chunks without locks can still access.
+	* Said threads announce the global epoch at which they started reading with a chunkReadGuard.
+	* Memory that has just been made unreachable (replaced block data buffers and storage views, or unloaded chunks)
+	* is tagged with the epoch at which it was retired and is only freed or reused once no reader
+	* that started at or before said epoch is still active.
+	*/
+	class chunkReclaimer {
+
+	public:
+
+		// Observers.
+
+		/**
+		* @brief Returns true if no active reader can access memory retired at the specified epoch.
+		*/
+		static bool isSafe(std::uint64_t epoch);
+
+		/**
+		* @brief Returns the number of retired block data buffers and storage views waiting to be freed.
+		*/
+		static std::size_t nRetired();
+
+
+		// Modifiers.
+
+		/**
+		* @brief Marks the calling thread as an active reader. Calls can be nested.
+		* Prefer chunkReadGuard over calling this method directly.
+		*/
+		static void enter();
+
+		/**
+		* @brief Ends the innermost read started by the calling thread with chunkReclaimer::enter().
+		*/
+		static void exit();
+
+		/**
+		* @brief Advances the global epoch and returns the epoch that the memory that has just been
+		* made unreachable by the calling thread must be tagged with.
+		*/
+		static std::uint64_t retireEpoch();
+
+		/**
+		* @brief Retires the specified block data buffers and storage view. They are freed once no active reader can access them.
+		* WARNING. They must already be unreachable for readers that start after this call.
+		*/
+		static void retire(std::vector<std::vector<block>>&& palettes, std::vector<std::vector<std::uint64_t>>&& blockWords,
+						   const chunkBlockStorageView* view);
+
+		/**
+		* @brief Frees the retired block data buffers and storage views that no active reader can access anymore.
+		*/
+		static void reclaim();
+
+
+		// Clean up.
+
+		/**
+		* @brief Frees all retired block data buffers and storage views.
+		* WARNING. No reader can be active.
+		*/
+		static void cleanUp();
+
+	private:
+
+		/*
+		Block data buffers and storage view retired at the same epoch.
+		*/
+		struct retiredStorage {
+
+			std::uint64_t epoch;
+			std::vector<std::vector<block>> palettes;
+			std::vector<std::vector<std::uint64_t>> blockWords;
+			std::unique_ptr<const chunkBlockStorageView> view;
+
+		};
+
+		/*
+		Reader slot of a thread and the number of nested reads the thread is in.
+		The slot is claimed the first time the thread reads and freed when the thread exits.
+		*/
+		struct readerState {
+
+			int slot = -1;
+			unsigned int depth = 0;
+
+			~readerState();
+
+		};
+
+		/*
+		Epoch announced by the reader of a slot or 0 if the slot's reader is not reading.
+		Each one takes a whole cache line so that readers do not invalidate each other's slots.
+		*/
+		struct alignas(64) readerEpoch {
+
+			std::atomic<std::uint64_t> epoch;
+
+		};
+
+		static std::atomic<std::uint64_t> epoch_;
+		static readerEpoch readerEpochs_[CHUNK_MAX_READER_THREADS];
+		static std::atomic<bool> readerSlotsUsed_[CHUNK_MAX_READER_THREADS];
+		static thread_local readerState reader_;
+
+		static std::deque<retiredStorage> retired_;
+		static std::mutex retiredMutex_;
+
+
+		/*
+		Claims a free reader slot for the calling thread.
+		*/
+		static int claimReaderSlot_();
+
+		/*
+		Returns the oldest epoch announced by an active reader or UINT64_MAX if there is not any.
+		*/
+		static std::uint64_t oldestActiveEpoch_();
+
+		/*
+		Frees the retired memory that no active reader can access anymore.
+		WARNING. Does not lock 'retiredMutex_'.
+		*/
+		static void reclaim_();
+
+	};
+
+	inline void chunkReclaimer::enter() {
+
+		readerState& reader = reader_;
+
+		if (reader.depth++ == 0) {
+
+			if (reader.slot == -1)
+				reader.slot = claimReaderSlot_();
+
+			// The announcement is only valid if the global epoch did not advance before it became visible
+			// to the threads that retire memory, as they could have missed it otherwise.
+			std::atomic<std::uint64_t>& announcedEpoch = readerEpochs_[reader.slot].epoch;
+			std::uint64_t epoch = 0;
+			do {
+
+				epoch = epoch_.load();
+				announcedEpoch.store(epoch);
+
+			} while (epoch != epoch_.load());
+
+		}
+
+	}
+
+	inline void chunkReclaimer::exit() {
+
+		readerState& reader = reader_;
+
+		if (--reader.depth == 0)
+			readerEpochs_[reader.slot].epoch.store(0, std::memory_order_release);
+
+	}
+
+	inline std::uint64_t chunkReclaimer::retireEpoch() {
+
+		return epoch_.fetch_add(1);
+
+	}
+
+
+	/**
+	* @brief Marks the calling thread as an active chunk reader during its lifetime (see chunkReclaimer).
+	* Any chunk, neighbor chunk link or block data obtained without locking while the guard is alive
+	* is not freed or reused until the guard is destroyed.
+	*/
+	class chunkReadGuard {
+
+	public:
+
+		chunkReadGuard();
+
+		chunkReadGuard(const chunkReadGuard&) = delete;
+
+		chunkReadGuard& operator=(const chunkReadGuard&) = delete;
+
+		~chunkReadGuard();
+
+	};
+
+	inline chunkReadGuard::chunkReadGuard() {
+
+		chunkReclaimer::enter();
+
+	}
+
+	inline chunkReadGuard::~chunkReadGuard() {
+
+		chunkReclaimer::exit();
+
+	}
+
+
 	/**
 	* @brief Represents a section of the voxel world, with its blocks, mesh, position and other infomation.
 	* Chunks that are marked as 'dirty' or 'changed' will have their mesh regenerated.
@@ -109,6 +570,15 @@ namespace VoxelEng {
 		chunk(const chunk& source);
 
 
+		// Destructors.
+
+		/**
+		* @brief Frees the chunk's current storage view.
+		* WARNING. No reader can access the chunk anymore.
+		*/
+		~chunk();
+
+
 		// Observers.
 
 		/**
@@ -119,49 +589,104 @@ namespace VoxelEng {
 
 		/**
 		* @brief Get the ID of the cube at the specifeid chunk-local coordinates.
+		* This method does not lock the chunk's block data mutex, so any number of threads
+		* can read blocks concurrently while another thread modifies the chunk.
 		*/
 		block getBlock(GLbyte x, GLbyte y, GLbyte z);
 
 		/**
 		* @brief Get the ID of the cube at the specifeid chunk-local coordinates.
+		* This method does not lock the chunk's block data mutex, so any number of threads
+		* can read blocks concurrently while another thread modifies the chunk.
 		*/
 		block getBlock(const vec3& inChunkPos);
 
 		/**
-		* @brief Get chunk's x axis coordinate (chunk-grid coordinate system).
+		* @brief Get the ID of the cube with the specified linear index.
+		* This method does not lock the chunk's block data mutex, so any number of threads
+		* can read blocks concurrently while another thread modifies the chunk.
 		*/
-		GLbyte x() const;
+		block getBlockLinear(unsigned int linearIndex);
 
 		/**
-		* @brief Get chunk's y axis coordinate (chunk-grid coordinate system).
+		* @brief Calls 'function(x, y, z, blockID)' for each block in the box defined by the chunk-local
+		* positions (x1, y1, z1) and (x2, y2, z2) (both included), visiting them in increasing X, Y and Z order.
+		* The chunk's block data mutex is locked in shared mode once for the whole operation.
+		* WARNING. 'function' must not modify the chunk.
 		*/
-		GLbyte y() const;
+		template <typename F>
+		void forEachInBox(GLbyte x1, GLbyte y1, GLbyte z1, GLbyte x2, GLbyte y2, GLbyte z2, F&& function);
 
 		/**
-		* @brief Get chunk's z axis coordinate (chunk-grid coordinate system).
+		* @brief Returns the linear index of the block at the specified chunk-local coordinates.
+		* Linear indices follow the order in which chunks store their blocks (see CHUNK_MORTON_LAYOUT).
 		*/
-		GLbyte z() const;
+		static unsigned int linearIndex(GLbyte x, GLbyte y, GLbyte z);
 
 		/**
-		* @brief Get chunk's coordinate (chunk-grid coordinate systems).
+		* @brief Returns the chunk-local coordinates of the block with the specified linear index.
 		*/
-		const vec3& chunkPos() const;
+		static vec3 blockCoords(unsigned int linearIndex);
 
 		/**
-		* @brief Get this chunk's global position.
+		* @brief Returns the algorithm currently used to generate the meshes of chunks.
 		*/
-		const vec3& pos() const;
+		static chunkMeshingMode meshingMode();
 
 		/**
-		* @brief Get this chunk's vertex data.
+		* @brief Returns the number of old meshes kept by all chunks to build their next meshes into
+		* (see CHUNK_MAX_SPARE_MESHES).
 		*/
-		const std::vector<vertex>& vertices() const;
+		static unsigned int nSpareMeshes();
 
 		/**
-		* @brief Get this chunk's rendering data object.
+		* @brief Get the level of detail the chunk's mesh is built at (see CHUNK_N_LODS).
 		*/
-		const chunkRenderingData& renderingData() const;
-	
+		unsigned int lod() const;
+
+		/**
+		* @brief Get chunk's x axis coordinate (chunk-grid coordinate system).
+		*/
+		GLbyte x() const;
+
+		/**
+		* @brief Get chunk's y axis coordinate (chunk-grid coordinate system).
+		*/
+		GLbyte y() const;
+
+		/**
+		* @brief Get chunk's z axis coordinate (chunk-grid coordinate system).
+		*/
+		GLbyte z() const;
+
+		/**
+		* @brief Get chunk's coordinate (chunk-grid coordinate systems).
+		*/
+		const vec3& chunkPos() const;
+
+		/**
+		* @brief Get the loaded chunk that is next to this one in the specified direction
+		* or nullptr if there is not any. Neighbor links are maintained by the chunk manager
+		* system when chunks are loaded and unloaded.
+		*/
+		chunk* neighbor(blockViewDir direction) const;
+
+		/**
+		* @brief Get this chunk's global position.
+		*/
+		const vec3& pos() const;
+
+		/**
+		* @brief Get this chunk's mesh.
+		* Returns a null pointer if the chunk has no mesh.
+		*/
+		const chunkMesh& mesh() const;
+
+		/**
+		* @brief Get this chunk's rendering data object.
+		*/
+		const chunkRenderingData& renderingData() const;
+	
 		/**
 		* @brief Get the number of non-null blocks (blocks with ID != 0) that exist in the chunk.
 		*/
@@ -178,6 +703,30 @@ namespace VoxelEng {
 		*/
 		chunkLoadLevel loadLevel() const;
 
+		/**
+		* @brief Returns the number of bits used to store each block of the chunk.
+		* It is equal to CHUNK_RAW_BLOCK_BITS if the chunk stores raw block IDs
+		* instead of palette indices and 0 if the chunk is uniform.
+		*/
+		unsigned int bitsPerBlock() const;
+
+		/**
+		* @brief Returns true if the chunk stores raw block IDs instead of
+		* palette-compressed block data or false otherwise.
+		*/
+		bool rawStorage() const;
+
+		/**
+		* @brief Returns true if all the blocks of the chunk have the same ID and
+		* the chunk stores only said ID instead of per-block data or false otherwise.
+		*/
+		bool uniform() const;
+
+		/**
+		* @brief Returns the amount of main memory (in bytes) used to store the chunk's block data.
+		*/
+		std::size_t blockDataSize();
+
 
 		// Modifiers.
 
@@ -202,6 +751,27 @@ namespace VoxelEng {
 		*/
 		block setBlock(unsigned int linearIndex, block blockID);
 
+		/**
+		* @brief Fills the box defined by the chunk-local positions (x1, y1, z1) and (x2, y2, z2)
+		* (both included) with the specified block ID.
+		* The chunk is locked and marked as dirty only once for the whole operation.
+		*/
+		void fillBox(GLbyte x1, GLbyte y1, GLbyte z1, GLbyte x2, GLbyte y2, GLbyte z2, block blockID);
+
+		/**
+		* @brief Sets 'length' consecutive blocks starting at the block with the specified linear index
+		* to the specified block ID. With the Morton layout, a run of 8^n blocks starting at a multiple
+		* of 8^n is a cube of side 2^n. Otherwise, a run of SCZ blocks starting at a multiple of SCZ is a full block column.
+		* The chunk is locked and marked as dirty only once for the whole operation.
+		*/
+		void setBlockRun(unsigned int linearIndex, unsigned int length, block blockID);
+
+		/**
+		* @brief Applies all the specified block modifications.
+		* The chunk is locked and marked as dirty only once for the whole operation.
+		*/
+		void setBlocks(std::span<const blockEdit> edits);
+
 		/**
 		* @brief Returns the chunk's chunk position.
 		*/
@@ -230,6 +800,8 @@ namespace VoxelEng {
 
 		/**
 		* @brief Regenerate the chunk's mesh.
+		* Only the sections of the chunk marked as dirty since the last call are meshed again,
+		* while the vertices of the rest of sections are kept from the current mesh.
 		*/
 		void renewMesh();
 
@@ -238,153 +810,995 @@ namespace VoxelEng {
 		*/
 		void makeEmpty();
 
+		/**
+		* @brief The chunk's block data will be filled with the specified block ID.
+		* The chunk is stored as a uniform chunk until a different block ID is set in it.
+		*/
+		void makeUniform(block blockID);
+
+		/**
+		* @brief Turns the chunk into a uniform chunk if all its blocks have the same ID.
+		* Returns true if the chunk is uniform after the call or false otherwise.
+		*/
+		bool compact();
+
 		/**
 		* @brief Set the chunk's load level.
 		*/
 		void setLoadLevel(chunkLoadLevel level);
 
-		/**
-		* @brief Reuse a chunk object by assigning it a new chunk position and generating/loading
-		* new terrain on it by previously cleaning any previous data.
-		*/
-		void regenChunk(bool empty, const vec3& chunkPos);
+		/**
+		* @brief Reuse a chunk object by assigning it a new chunk position and generating/loading
+		* new terrain on it by previously cleaning any previous data.
+		*/
+		void regenChunk(bool empty, const vec3& chunkPos);
+
+
+		/*
+		Clean up.
+		*/
+
+		/**
+		* @brief Clean up any resources allocated for the class' static methods.
+		*/ 
+		static void cleanUp();
+	
+	private:
+
+		/*
+		Friend classes.
+		*/
+
+		friend chunkManager;
+		friend chunkEditSession;
+		friend chunkPool;
+
+
+		/*
+		Nested types.
+		*/
+
+		/*
+		Visible faces of a chunk's blocks. For each face (in the order front, back, top, bottom, right and left),
+		'masks[face][i][j]' has its k-th bit set if said face of the block at position k along the face's normal axis
+		in the column (i, j) is visible. Columns are indexed by the other two axes in cyclic order, that is,
+		by (Y, Z) for faces along the X axis, (Z, X) for faces along the Y axis and (X, Y) for faces along the Z axis.
+		*/
+		struct faceMasks {
+
+			std::uint16_t masks[6][SCX][SCX];
+
+		};
+
+		static_assert(SCX <= 16, "Face masks hold a chunk's column of blocks in 16 bits");
+
+		/*
+		Precomputed data of a block face used by the meshers. For each of the face's vertices, 'vertices' holds
+		its packed 'chunkVertex::position' for the face of the block at the chunk's origin, 'corners' the axes along
+		which it is offset from the block's origin (bit 0 for X, 1 for Y and 2 for Z) and 'textureCorners' the
+		texture axes along which it is at the far end of the texture (bit 0 for the horizontal axis and 1 for
+		the vertical one). 'textureAxes' holds the chunk axes that the texture's horizontal and vertical axes run along.
+		*/
+		struct faceTemplate {
+
+			GLuint vertices[CHUNK_VERTICES_PER_FACE];
+			unsigned int corners[CHUNK_VERTICES_PER_FACE];
+			unsigned int textureCorners[CHUNK_VERTICES_PER_FACE];
+			unsigned int textureAxes[2];
+
+		};
+
+
+		/*
+		Attributes.
+		*/
+
+		static bool initialised_;
+		static const model* blockVertices_;
+		static const modelTriangles* blockTriangles_;
+		static std::atomic<chunkMeshingMode> meshingMode_;
+
+		/*
+		Copy of the blocks of the chunk being meshed by the calling thread plus a one block
+		border with the blocks of its neighbor chunks (see chunk::paddedIndex_).
+		*/
+		static thread_local block paddedBlocks_[CHUNK_PADDED_VOLUME];
+
+		/*
+		Downsampled copy of 'paddedBlocks_' used to mesh chunks at a level of detail other than 0.
+		It has the same layout as 'paddedBlocks_', but only its first SCX / 2^lod + 2 positions
+		along each axis are used.
+		*/
+		static thread_local block lodBlocks_[CHUNK_PADDED_VOLUME];
+
+		/*
+		Positions (as indices of 'paddedBlocks_') of the blocks pending to be visited while
+		computing the face connectivity of the chunk being meshed by the calling thread.
+		*/
+		static thread_local std::uint16_t floodFillStack_[N_CHUNK_BLOCKS];
+
+		static faceTemplate faceTemplates_[6];
+
+		static std::atomic<std::uint64_t> nMeshesBuilt_;
+		static std::atomic<unsigned int> nSpareMeshes_;
+
+		/*
+		Block data is stored as a palette with the IDs of the blocks present in the chunk
+		and an array of 'bitsPerBlock_' bit-packed palette indices (one per block).
+		The palette grows (doubling the bits per block) as new block IDs are placed in the chunk.
+		If more than CHUNK_MAX_PALETTE_BITS bits per block would be needed, the palette
+		is discarded and the raw block IDs are stored in the same packed array instead.
+		Uniform chunks use 0 bits per block and store their only block ID in 'palette_[0]'.
+		*/
+		std::vector<block> palette_;
+		std::vector<std::uint64_t> blockWords_;
+		unsigned int bitsPerBlock_;
+
+		/*
+		Lock-free block reads are implemented as a sequence lock over the block data.
+		Writers (which hold 'blocksMutex_' in exclusive mode) make 'blockDataVersion_' odd
+		while they modify the block data and even again once they have finished.
+		Readers retry whenever the version was odd or changed during their read.
+		Each time the storage layout changes, a new view is published in 'storageView_'.
+		Replaced palettes and block words are kept in 'retiredPalettes_' and 'retiredBlockWords_'
+		until the next view is published. Then they are handed to the chunk reclaimer together
+		with the replaced view, so that readers holding an old view never access freed memory.
+		A palette is always reserved with enough capacity for all the IDs that its number of
+		bits per block can index, so adding IDs to it never moves it while its view is published.
+		*/
+		std::atomic<unsigned int> blockDataVersion_;
+		std::atomic<const chunkBlockStorageView*> storageView_;
+		std::vector<std::vector<block>> retiredPalettes_;
+		std::vector<std::vector<std::uint64_t>> retiredBlockWords_;
+
+		/*
+		Links to the loaded neighbor chunks, indexed by 'blockViewDir' (minus one).
+		*/
+		std::atomic<chunk*> neighbors_[6];
+
+		/*
+		Bitmask of the sections whose part of the chunk's mesh must be rebuilt and index of the
+		first vertex of each part in the chunk's mesh, which stores the vertices of each part
+		contiguously and in order. The mesh is divided in sections with naive meshing and in
+		face layers with greedy meshing, and 'partsMeshingMode_' is the meshing mode of the offsets.
+		*/
+		std::atomic<std::uint64_t> dirtySections_;
+		unsigned int partVertexOffsets_[CHUNK_N_FACE_LAYERS + 1];
+		chunkMeshingMode partsMeshingMode_;
+
+		std::atomic<unsigned int> lod_;
+
+		std::atomic<bool> changed_;
+		std::atomic<unsigned int> nBlocks_;
+		std::atomic<chunkLoadLevel> loadLevel_;
+		chunkRenderingData renderingData_;
+
+		/*
+		Meshes replaced by the chunk's current mesh. They are reused to build the chunk's next meshes
+		once the rendering thread no longer holds them, so that remeshing does not allocate memory.
+		The number of spare meshes of all chunks is kept in 'nSpareMeshes_' and bounded by CHUNK_MAX_SPARE_MESHES.
+		*/
+		chunkMesh spareMeshes_[CHUNK_SPARE_MESHES];
+
+		/*
+		Used for reading the block data in a chunk.
+		All meshing threads only read this data, so they access it
+		in shared mode, while any thread that can alter this data
+		must access it in exclusive/unique mode.
+		*/
+		std::shared_mutex blocksMutex_;
+
+
+		/*
+		Methods.
+		*/
+
+		// Observers.
+
+		/*
+		Returns the linear index of the block at the specified chunk-local coordinates.
+		*/
+		static unsigned int linearIndex_(unsigned int x, unsigned int y, unsigned int z);
+
+		/*
+		Gets the chunk-local coordinates of the block with the specified linear index.
+		*/
+		static void blockCoords_(unsigned int linearIndex, unsigned int& x, unsigned int& y, unsigned int& z);
+
+		/*
+		Spreads the 4 lowest bits of 'value' so that there are two zero bits between each of them.
+		*/
+		static unsigned int spreadBits_(unsigned int value);
+
+		/*
+		Inverse of spreadBits_.
+		*/
+		static unsigned int compactBits_(unsigned int value);
+
+		/*
+		Get the ID of the block with the specified linear index.
+		WARNING. Does not lock 'blocksMutex_'.
+		*/
+		block getBlock_(unsigned int linearIndex) const;
+
+		/*
+		Get the ID of the block with the specified linear index without locking 'blocksMutex_'
+		and in a way that is safe against concurrent writers.
+		*/
+		block readBlock_(unsigned int linearIndex) const;
+
+		/*
+		Same as 'readBlock_', for methods that read many blocks under a single chunkReadGuard.
+		WARNING. The calling thread must hold a chunkReadGuard.
+		*/
+		block readBlockUnguarded_(unsigned int linearIndex) const;
+
+		/*
+		Returns the index of the section that contains the block at the specified chunk-local coordinates.
+		*/
+		static unsigned int sectionIndex_(unsigned int x, unsigned int y, unsigned int z);
+
+		/*
+		Adds to 'sections' the sections of the chunk whose mesh can change when the block with the
+		specified linear index is modified, and to 'neighborSections' (indexed by 'blockViewDir' minus one)
+		the sections of the neighbor chunks whose mesh can change too.
+		*/
+		static void blockDirtySections_(unsigned int linearIndex, std::uint64_t& sections, std::uint64_t neighborSections[6]);
+
+		/*
+		Returns the sections that are adjacent to the chunk's face in the specified direction.
+		*/
+		static std::uint64_t borderSections_(blockViewDir direction);
+
+		/*
+		Returns the sections that the specified face layer (see 'CHUNK_N_FACE_LAYERS') crosses.
+		*/
+		static std::uint64_t layerSections_(unsigned int layer);
+
+		/*
+		Returns the index in a padded copy of a chunk's blocks of the block at the specified
+		padded coordinates, which are the chunk-local coordinates plus one.
+		*/
+		static unsigned int paddedIndex_(unsigned int x, unsigned int y, unsigned int z);
+
+		/*
+		Copies into 'paddedBlocks' the chunk's blocks and the blocks of the neighbor chunks
+		that touch its faces.
+		WARNING. Does not lock 'blocksMutex_' nor the neighbor chunks' block data mutexes.
+		*/
+		void copyPaddedBlocks_(chunk* const neighborChunks[6], block* paddedBlocks);
+
+		/*
+		Sets to air the blocks of the border of 'paddedBlocks' that touch the specified face (see 'faceMasks').
+		*/
+		static void clearPaddedBorder_(unsigned int face, block* paddedBlocks);
+
+		/*
+		Downsamples a padded copy of a chunk's blocks into cells of 'scale' blocks along each axis, each one
+		holding its most common block ID (solid blocks win ties with air). The border cells are downsampled from
+		the one block thick border of 'paddedBlocks'. The result has the layout described in 'lodBlocks_'.
+		*/
+		static void downsampleBlocks_(const block* paddedBlocks, unsigned int scale, block* lodBlocks);
+
+		/*
+		Computes which faces of the blocks of a padded copy of a chunk's blocks, of 'size' blocks along each axis,
+		are visible from bitmasks of the solid blocks of each column of the chunk, including the neighbor blocks
+		at the column's ends.
+		*/
+		static void buildFaceMasks_(const block* paddedBlocks, unsigned int size, faceMasks& faces);
+
+		/*
+		Returns the face connectivity (see 'chunkMeshData::faceConnectivity') of a padded copy of a chunk's
+		blocks by flood filling each region of connected non-solid blocks and connecting all the faces it touches.
+		*/
+		static std::uint64_t computeFaceConnectivity_(const block* paddedBlocks);
+
+		/*
+		Scales the positions and texture coordinates of the specified vertices by 'scale'.
+		*/
+		static void scaleVertices_(std::vector<chunkVertex>& vertices, unsigned int scale);
+
+		/*
+		Returns the number of visible faces of the blocks of the specified section.
+		*/
+		static unsigned int countSectionFaces_(unsigned int section, const faceMasks& faces);
+
+		/*
+		Returns the number of visible faces of the specified face layer.
+		*/
+		static unsigned int countLayerFaces_(unsigned int layer, const faceMasks& faces);
+
+		/*
+		Takes out a spare mesh ready to be cleared and built into. A new one is allocated
+		only if the chunk has no spare mesh that the rendering thread no longer holds.
+		*/
+		chunkMesh takeSpareMesh_();
+
+		/*
+		Keeps the specified replaced mesh as a spare mesh if the chunk has a free slot for it
+		and the global spare mesh budget is not spent. Otherwise the mesh is dropped.
+		*/
+		void keepSpareMesh_(chunkMesh mesh);
+
+		/*
+		Drops all the chunk's spare meshes and returns them to the global spare mesh budget.
+		*/
+		void releaseSpareMeshes_();
+
+		/*
+		Appends to 'vertices' the 4 vertices of the specified face (see 'faceMasks') of the box that starts at
+		the chunk-local position 'pos' and spans 'extent' blocks along each axis, with the texture of the
+		specified block repeated once per block across it.
+		*/
+		static void addFace_(unsigned int face, const unsigned int pos[3], const unsigned int extent[3], block blockID, std::vector<chunkVertex>& vertices);
+
+		/*
+		Appends to 'vertices' the mesh of the specified section, given the padded copy of the chunk's
+		blocks and the visible faces computed from it.
+		*/
+		static void meshSection_(unsigned int section, const block* paddedBlocks, const faceMasks& faces, std::vector<chunkVertex>& vertices);
+
+		/*
+		Appends to 'vertices' the mesh of the specified face layer, merging its adjacent
+		visible faces of blocks with the same ID into larger quads.
+		*/
+		static void greedyMeshLayer_(unsigned int layer, const block* paddedBlocks, const faceMasks& faces, std::vector<chunkVertex>& vertices);
+
+
+		// Modifiers.
+
+		/*
+		Sets the ID of the block with the specified linear index and updates the chunk's
+		number of non-null blocks. Returns the old ID of the modified block.
+		WARNING. Does not lock 'blocksMutex_'.
+		*/
+		block setBlock_(unsigned int linearIndex, block blockID);
+
+		/*
+		Sets the ID of the block with the specified linear index without updating
+		the chunk's number of non-null blocks nor notifying lock-free readers.
+		WARNING. Does not lock 'blocksMutex_'.
+		*/
+		void writeBlock_(unsigned int linearIndex, block blockID);
+
+		/*
+		Marks the specified sections of the chunk and of its neighbors as dirty.
+		Neighbors with dirty sections are also flagged as changed.
+		*/
+		void markDirty_(std::uint64_t sections, const std::uint64_t neighborSections[6]);
+
+		/*
+		Marks all the sections of the chunk as dirty along with the sections of its neighbors that border it.
+		*/
+		void markAllDirty_();
+
+		/*
+		Recomputes the chunk's number of non-null blocks from its block data.
+		WARNING. Does not lock 'blocksMutex_'.
+		*/
+		void countBlocks_();
+
+		/*
+		Replaces the chunk's block data with a copy of the block data of 'other'.
+		WARNING. Does not lock 'blocksMutex_' nor notify lock-free readers.
+		*/
+		void copyBlocks_(const chunk& other);
+
+		/*
+		Returns the value that represents 'blockID' in the packed block data,
+		adding it to the palette and growing the storage if necessary.
+		WARNING. Does not lock 'blocksMutex_'.
+		*/
+		unsigned int paletteIndex_(block blockID);
+
+		/*
+		Repacks the chunk's block data using 'bitsPerBlock' bits per block.
+		If 'bitsPerBlock' is equal to CHUNK_RAW_BLOCK_BITS, the palette is discarded
+		and the raw block IDs are stored.
+		WARNING. Does not lock 'blocksMutex_'.
+		*/
+		void repackBlocks_(unsigned int bitsPerBlock);
+
+		/*
+		Resets the block data so that the chunk is a uniform chunk filled with 'blockID'.
+		WARNING. Does not lock 'blocksMutex_'.
+		*/
+		void setUniform_(block blockID);
+
+		/*
+		Publishes the current layout of the block data for lock-free readers and retires
+		the replaced view and block data buffers (see chunkReclaimer).
+		WARNING. Does not lock 'blocksMutex_'.
+		*/
+		void publishStorage_();
+
+		/*
+		Resets the chunk's neighbor links, meshes, level of detail, load level and dirty state
+		to those of a newly constructed chunk, so that it can be reused for another chunk position.
+		WARNING. No other thread can access the chunk.
+		*/
+		void reset_();
+
+		/*
+		Marks the beginning of a modification of the block data for lock-free readers.
+		WARNING. Does not lock 'blocksMutex_'.
+		*/
+		void beginBlockDataWrite_();
+
+		/*
+		Marks the end of a modification of the block data for lock-free readers.
+		WARNING. Does not lock 'blocksMutex_'.
+		*/
+		void endBlockDataWrite_();
+
+	};
+
+
+	/**
+	* @brief Groups several modifications of a chunk's blocks so that the chunk's block data
+	* mutex is locked only once and the chunk's number of non-null blocks is recomputed and
+	* the chunk is marked as dirty only once, when the session is destroyed.
+	* WARNING. Lock-free readers of the chunk wait until the session ends, so sessions
+	* should be kept as short as possible. The chunk must not be accessed through
+	* its own methods while the session exists.
+	*/
+	class chunkEditSession {
+
+	public:
+
+		// Constructors.
+
+		/**
+		* @brief Starts an edit session on the specified chunk.
+		*/
+		chunkEditSession(chunk& chunk);
+
+		chunkEditSession(const chunkEditSession&) = delete;
+
+
+		// Observers.
+
+		/**
+		* @brief Returns the chunk position of the edited chunk.
+		*/
+		const vec3& chunkPos() const;
+
+		/**
+		* @brief Get the ID of the block at the specified chunk-local coordinates.
+		*/
+		block getBlock(GLbyte x, GLbyte y, GLbyte z) const;
+
+		/**
+		* @brief Get the ID of the block at the specified chunk-local coordinates.
+		*/
+		block getBlock(const vec3& inChunkPos) const;
+
+
+		// Modifiers.
+
+		chunkEditSession& operator=(const chunkEditSession&) = delete;
+
+		/**
+		* @brief Sets the ID of the block at the specified chunk-local coordinates.
+		*/
+		void setBlock(GLbyte x, GLbyte y, GLbyte z, block blockID);
+
+		/**
+		* @brief Sets the ID of the block at the specified chunk-local coordinates.
+		*/
+		void setBlock(const vec3& inChunkPos, block blockID);
+
+		/**
+		* @brief Sets the ID of the block with the specified linear index.
+		*/
+		void setBlock(unsigned int linearIndex, block blockID);
+
+		/**
+		* @brief Sets 'length' consecutive blocks starting at the block with the specified linear index.
+		*/
+		void setBlockRun(unsigned int linearIndex, unsigned int length, block blockID);
+
+		/**
+		* @brief Fills the box defined by the chunk-local positions (x1, y1, z1) and (x2, y2, z2)
+		* (both included) with the specified block ID.
+		*/
+		void fillBox(GLbyte x1, GLbyte y1, GLbyte z1, GLbyte x2, GLbyte y2, GLbyte z2, block blockID);
+
+		/**
+		* @brief Applies all the specified block modifications.
+		*/
+		void setBlocks(std::span<const blockEdit> edits);
+
+
+		// Destructors.
+
+		/**
+		* @brief Ends the edit session.
+		*/
+		~chunkEditSession();
+
+	private:
+
+		chunk& chunk_;
+		std::unique_lock<std::shared_mutex> lock_;
+		bool modified_;
+
+		/*
+		Dirty sections of the edited chunk and of its neighbors (indexed by 'blockViewDir' minus one)
+		accumulated during the session.
+		*/
+		std::uint64_t dirtySections_,
+					  neighborDirtySections_[6];
+
+	};
+
+	inline bool chunk::initialised() {
+	
+		return initialised_;
+	
+	}
+
+	inline chunkMeshingMode chunk::meshingMode() {
+
+		return meshingMode_;
+
+	}
+
+	inline unsigned int chunk::nSpareMeshes() {
+
+		return nSpareMeshes_;
+
+	}
+
+	inline unsigned int chunk::lod() const {
+
+		return lod_;
+
+	}
+
+	inline GLbyte chunk::x() const {
+
+		return renderingData_.chunkPos.x;
+
+	}
+
+	inline GLbyte chunk::y() const {
+
+		return renderingData_.chunkPos.y;
+
+	}
+
+	inline GLbyte chunk::z() const {
+
+		return renderingData_.chunkPos.z;
+
+	}
+
+	inline const vec3& chunk::chunkPos() const {
+
+		return renderingData_.chunkPos;
+
+	}
+
+	inline vec3& chunk::chunkPos() {
+
+		return renderingData_.chunkPos;
+	
+	}
+
+	inline chunk* chunk::neighbor(blockViewDir direction) const {
+
+		return (direction == blockViewDir::NONE) ? nullptr : neighbors_[static_cast<int>(direction) - 1].load(std::memory_order_acquire);
+
+	}
+
+	inline const vec3& chunk::pos() const {
+
+		return vec3(renderingData_.chunkPos.x * SCX, renderingData_.chunkPos.y * SCY, renderingData_.chunkPos.z * SCZ);
+
+	}
+
+	inline const chunkMesh& chunk::mesh() const {
+
+		return renderingData_.mesh;
+
+	}
+
+	inline const chunkRenderingData& chunk::renderingData() const {
+
+		return renderingData_;
+
+	}
+
+	inline unsigned int chunk::getNBlocks() {
+
+		return nBlocks_;
+
+	}
+
+	inline const std::atomic<bool>& chunk::changed() const {
+
+		return changed_;
+
+	}
+
+	inline chunkLoadLevel chunk::loadLevel() const {
+
+		return loadLevel_;
+
+	}
+
+	inline unsigned int chunk::bitsPerBlock() const {
+
+		return bitsPerBlock_;
+
+	}
+
+	inline bool chunk::rawStorage() const {
+
+		return bitsPerBlock_ == CHUNK_RAW_BLOCK_BITS;
+
+	}
+
+	inline bool chunk::uniform() const {
+
+		return bitsPerBlock_ == 0;
+
+	}
+
+	inline chunkRenderingData& chunk::renderingData() {
+
+		return renderingData_;
+
+	}
+
+	inline void chunk::setNBlocks(unsigned int nBlocks) {
+
+		nBlocks_ = nBlocks;
+
+	}
+
+	inline std::shared_mutex& chunk::blockDataMutex() {
+
+		return blocksMutex_;
+
+	}
+
+	inline std::atomic<bool>& chunk::changed() {
+
+		return changed_;
+
+	}
+
+	inline void chunk::setLoadLevel(chunkLoadLevel level) {
+
+		loadLevel_ = level;
+
+	}
+
+	inline block chunk::getBlockLinear(unsigned int linearIndex) {
+
+		return readBlock_(linearIndex);
+
+	}
+
+	template <typename F>
+	void chunk::forEachInBox(GLbyte x1, GLbyte y1, GLbyte z1, GLbyte x2, GLbyte y2, GLbyte z2, F&& function) {
+
+		GLbyte minX = std::min(x1, x2), maxX = std::max(x1, x2),
+			   minY = std::min(y1, y2), maxY = std::max(y1, y2),
+			   minZ = std::min(z1, z2), maxZ = std::max(z1, z2);
+
+		std::shared_lock<std::shared_mutex> lock(blocksMutex_);
 
+		bool uniformChunk = uniform();
+		block blockID = (uniformChunk) ? palette_[0] : 0;
+		for (GLbyte x = minX; x <= maxX; x++)
+			for (GLbyte y = minY; y <= maxY; y++)
+				for (GLbyte z = minZ; z <= maxZ; z++)
+					function(x, y, z, (uniformChunk) ? blockID : getBlock_(linearIndex_(x, y, z)));
 
-		/*
-		Clean up.
-		*/
+	}
 
-		/**
-		* @brief Clean up any resources allocated for the class' static methods.
-		*/ 
-		static void cleanUp();
-	
-	private:
+	inline unsigned int chunk::linearIndex(GLbyte x, GLbyte y, GLbyte z) {
 
-		static bool initialised_;
-		static const model* blockVertices_;
-		static const modelTriangles* blockTriangles_;
+		return linearIndex_(x, y, z);
 
-		block blocks_[SCX][SCY][SCZ];
-		std::atomic<bool> changed_;
-		std::atomic<unsigned int> nBlocks_;
-		std::atomic<chunkLoadLevel> loadLevel_;
-		chunkRenderingData renderingData_;
+	}
 
-		/*
-		Used for reading the block data in a chunk.
-		All meshing threads only read this data, so they access it
-		in shared mode, while any thread that can alter this data
-		must access it in exclusive/unique mode.
-		*/
-		std::shared_mutex blocksMutex_;
+	inline vec3 chunk::blockCoords(unsigned int linearIndex) {
 
-	};
+		unsigned int x = 0,
+					 y = 0,
+					 z = 0;
+		blockCoords_(linearIndex, x, y, z);
+
+		return vec3(x, y, z);
 
-	inline bool chunk::initialised() {
-	
-		return initialised_;
-	
 	}
 
-	inline GLbyte chunk::x() const {
+	inline unsigned int chunk::linearIndex_(unsigned int x, unsigned int y, unsigned int z) {
 
-		return renderingData_.chunkPos.x;
+		if constexpr (CHUNK_MORTON_LAYOUT)
+			return (spreadBits_(x) << 2) | (spreadBits_(y) << 1) | spreadBits_(z);
+		else
+			return x * SCY * SCZ + y * SCZ + z;
 
 	}
 
-	inline GLbyte chunk::y() const {
+	inline unsigned int chunk::paddedIndex_(unsigned int x, unsigned int y, unsigned int z) {
 
-		return renderingData_.chunkPos.y;
+		return (x * CHUNK_PADDED_SIZE + y) * CHUNK_PADDED_SIZE + z;
 
 	}
 
-	inline GLbyte chunk::z() const {
+	inline void chunk::blockCoords_(unsigned int linearIndex, unsigned int& x, unsigned int& y, unsigned int& z) {
 
-		return renderingData_.chunkPos.z;
+		if constexpr (CHUNK_MORTON_LAYOUT) {
+
+			x = compactBits_(linearIndex >> 2);
+			y = compactBits_(linearIndex >> 1);
+			z = compactBits_(linearIndex);
+
+		}
+		else {
+
+			x = linearIndex / (SCY * SCZ);
+			y = linearIndex / SCZ % SCY;
+			z = linearIndex % SCZ;
+
+		}
 
 	}
 
-	inline const vec3& chunk::chunkPos() const {
+	inline unsigned int chunk::spreadBits_(unsigned int value) {
 
-		return renderingData_.chunkPos;
+		value = (value | (value << 4)) & 0xC3u;
+		return (value | (value << 2)) & 0x249u;
 
 	}
 
-	inline vec3& chunk::chunkPos() {
+	inline unsigned int chunk::compactBits_(unsigned int value) {
+
+		value &= 0x249u;
+		value = (value | (value >> 2)) & 0xC3u;
+		return (value | (value >> 4)) & 0xFu;
 
-		return renderingData_.chunkPos;
-	
 	}
 
-	inline const vec3& chunk::pos() const {
+	inline block chunk::getBlock_(unsigned int linearIndex) const {
 
-		return vec3(renderingData_.chunkPos.x * SCX, renderingData_.chunkPos.y * SCY, renderingData_.chunkPos.z * SCZ);
+		if (bitsPerBlock_ == 0)
+			return palette_[0];
+
+		std::size_t bit = static_cast<std::size_t>(linearIndex) * bitsPerBlock_;
+		block value = (blockWords_[bit >> 6] >> (bit & 63)) & ((1ull << bitsPerBlock_) - 1);
+
+		return (bitsPerBlock_ == CHUNK_RAW_BLOCK_BITS) ? value : palette_[value];
 
 	}
 
-	inline const std::vector<vertex>& chunk::vertices() const {
+	inline block chunk::readBlock_(unsigned int linearIndex) const {
 
-		return renderingData_.vertices;
+		chunkReadGuard guard;
+
+		return readBlockUnguarded_(linearIndex);
 
 	}
 
-	inline const chunkRenderingData& chunk::renderingData() const {
+	inline block chunk::readBlockUnguarded_(unsigned int linearIndex) const {
 
-		return renderingData_;
+		unsigned int version = 0;
+		block blockID = 0;
+		const chunkBlockStorageView* view = nullptr;
+		do {
+
+			version = blockDataVersion_.load(std::memory_order_acquire);
+			view = storageView_.load(std::memory_order_acquire);
+
+			if (view->bitsPerBlock == 0)
+				blockID = view->palette[0];
+			else {
+
+				std::size_t bit = static_cast<std::size_t>(linearIndex) * view->bitsPerBlock;
+				block value = (view->words[bit >> 6] >> (bit & 63)) & ((1ull << view->bitsPerBlock) - 1);
+				blockID = (view->bitsPerBlock == CHUNK_RAW_BLOCK_BITS) ? value : view->palette[value];
+
+			}
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+		} while ((version & 1) || version != blockDataVersion_.load(std::memory_order_relaxed));
+
+		return blockID;
 
 	}
 
-	inline unsigned int chunk::getNBlocks() {
+	inline void chunk::beginBlockDataWrite_() {
 
-		return nBlocks_;
+		blockDataVersion_.store(blockDataVersion_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
 
 	}
 
-	inline const std::atomic<bool>& chunk::changed() const {
+	inline void chunk::endBlockDataWrite_() {
 
-		return changed_;
+		blockDataVersion_.store(blockDataVersion_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
 
 	}
 
-	inline chunkLoadLevel chunk::loadLevel() const {
 
-		return loadLevel_;
+
+	// 'chunkEditSession' class.
+
+	inline const vec3& chunkEditSession::chunkPos() const {
+
+		return chunk_.chunkPos();
 
 	}
 
-	inline chunkRenderingData& chunk::renderingData() {
+	inline block chunkEditSession::getBlock(GLbyte x, GLbyte y, GLbyte z) const {
 
-		return renderingData_;
+		return chunk_.getBlock_(chunk::linearIndex_(x, y, z));
 
 	}
 
-	inline void chunk::setNBlocks(unsigned int nBlocks) {
+	inline block chunkEditSession::getBlock(const vec3& inChunkPos) const {
 
-		nBlocks_ = nBlocks;
+		return chunk_.getBlock_(chunk::linearIndex_((unsigned int)inChunkPos.x, (unsigned int)inChunkPos.y, (unsigned int)inChunkPos.z));
 
 	}
 
-	inline std::shared_mutex& chunk::blockDataMutex() {
+	inline void chunkEditSession::setBlock(GLbyte x, GLbyte y, GLbyte z, block blockID) {
 
-		return blocksMutex_;
+		setBlock(chunk::linearIndex_(x, y, z), blockID);
 
 	}
 
-	inline std::atomic<bool>& chunk::changed() {
+	inline void chunkEditSession::setBlock(const vec3& inChunkPos, block blockID) {
 
-		return changed_;
+		setBlock(chunk::linearIndex_((unsigned int)inChunkPos.x, (unsigned int)inChunkPos.y, (unsigned int)inChunkPos.z), blockID);
 
 	}
 
-	inline void chunk::setLoadLevel(chunkLoadLevel level) {
+	inline void chunkEditSession::setBlock(unsigned int linearIndex, block blockID) {
 
-		loadLevel_ = level;
+		chunk_.writeBlock_(linearIndex, blockID);
+		chunk::blockDirtySections_(linearIndex, dirtySections_, neighborDirtySections_);
+		modified_ = true;
 
 	}
 
+
+	/**
+	* @brief Slab allocator for chunk objects. Chunks are constructed in contiguous,
+	* cache-aligned slabs of memory, and released chunks are kept constructed in a free
+	* list so that acquiring them again reuses both their slot and their block data buffers.
+	* A released chunk is only handed out again once no lock-free reader that could have
+	* obtained a pointer to it before its release is still active (see chunkReclaimer).
+	* Until then, new slots are used instead.
+	*/
+	class chunkPool {
+
+	public:
+
+		// Initialisation.
+
+		/**
+		* @brief Ensures that the pool can hold at least the specified number of chunks
+		* without allocating more memory. The missing capacity is allocated as a single slab.
+		*/
+		static void reserve(std::size_t nChunks);
+
+
+		// Observers.
+
+		/**
+		* @brief Returns the number of chunks the pool can hold without allocating more memory.
+		*/
+		static std::size_t capacity();
+
+		/**
+		* @brief Returns the number of chunks currently acquired from the pool.
+		*/
+		static std::size_t nAcquiredChunks();
+
+
+		// Modifiers.
+
+		/**
+		* @brief Returns a chunk with the specified chunk position that is either empty
+		* or generated with the currently selected world generator.
+		*/
+		static chunk* acquire(bool empty, const vec3& chunkPos);
+
+		/**
+		* @brief Returns a copy of the specified chunk.
+		*/
+		static chunk* acquire(const chunk& original);
+
+		/**
+		* @brief Returns the specified chunk to the pool.
+		* WARNING. The chunk must not be registered in the chunk management system
+		* nor linked to any other chunk.
+		*/
+		static void release(chunk* selectedChunk);
+
+
+		// Clean up.
+
+		/**
+		* @brief Destroys all the pool's chunks and frees all its memory.
+		* WARNING. No chunk acquired from the pool can be used afterwards.
+		*/
+		static void cleanUp();
+
+	private:
+
+		/*
+		Contiguous block of chunk slots. Slots are constructed in order,
+		so the first 'nConstructed' slots always hold a chunk object.
+		*/
+		struct slab {
+
+			unsigned char* slots;
+			std::size_t nSlots,
+						nConstructed;
+
+		};
+
+		/*
+		Released chunk and the epoch at which it was released (see chunkReclaimer).
+		*/
+		struct releasedChunk {
+
+			chunk* selectedChunk;
+			std::uint64_t epoch;
+
+		};
+
+		static_assert(alignof(chunk) <= CHUNK_POOL_ALIGNMENT, "Chunk slots are not aligned enough to hold a chunk");
+
+		static constexpr std::size_t slotSize_ = (sizeof(chunk) + CHUNK_POOL_ALIGNMENT - 1) / CHUNK_POOL_ALIGNMENT * CHUNK_POOL_ALIGNMENT;
+
+		static std::vector<slab> slabs_;
+		static std::deque<releasedChunk> freeChunks_;
+		static std::size_t capacity_,
+						   nAcquiredChunks_;
+		static std::mutex mutex_;
+
+
+		/*
+		Returns the address of an unconstructed chunk slot, allocating a new slab if there is not any.
+		WARNING. Does not lock 'mutex_'.
+		*/
+		static void* allocateSlot_();
+
+		/*
+		Allocates a new slab with the specified number of chunk slots.
+		WARNING. Does not lock 'mutex_'.
+		*/
+		static void allocateSlab_(std::size_t nSlots);
+
+	};
+
 	
 
+	/**
+	* @brief Dense toroidal index of the loaded chunks. Each chunk position is mapped
+	* to a slot by taking its X and Z coordinates modulo the grid's width, while the Y
+	* coordinate is mapped directly as the world has a limited height.
+	* Each slot holds either nullptr or the chunk stored there, which must be checked
+	* against the queried chunk position since several positions share the same slot.
+	*/
+	struct chunkGrid {
+
+		int width;
+		std::vector<std::atomic<chunk*>> slots;
+
+	};
+
+
 	/**
 	* @brief Used for managing the chunks' life cycle, level loading...
 	*/
@@ -461,6 +1875,9 @@ namespace VoxelEng {
 
 		/**
 		* @brief Returns the system's dictionary of registered chunks.
+		* The chunk manager's chunk grid is used instead of this dictionary to select
+		* chunks whenever possible.
+		* WARNING. Lock chunksMutex() in shared mode while using the dictionary.
 		*/
 		static const std::unordered_map<vec3, chunk*>& chunks();
 
@@ -468,7 +1885,7 @@ namespace VoxelEng {
 		* @brief Returns the system's readable chunk vertex data. That is, it returns the system's chunk
 		* vertex data that is safe to read for the rendering thread in order to render them.
 		*/
-		static std::unordered_map<vec3, std::vector<vertex>> const* drawableChunksRead();
+		static std::unordered_map<vec3, chunkMesh> const* drawableChunksRead();
 
 		static unsigned int nChunksToCompute();
 
@@ -559,6 +1976,25 @@ namespace VoxelEng {
 		*/
 		static void setNChunksToCompute(unsigned int nChunksToCompute);
 
+		/**
+		* @brief Set the algorithm used to generate the meshes of chunks.
+		* All loaded chunks are marked to have their meshes regenerated with it.
+		*/
+		static void setMeshingMode(chunkMeshingMode mode);
+
+		/**
+		* @brief Set the distance (in chunks) to the player from which chunks are meshed at the
+		* specified level of detail (between 1 and CHUNK_N_LODS - 1) with an infinite world.
+		*/
+		static void setLODDistance(unsigned int lod, unsigned int distance);
+
+		/**
+		* @brief Set the level of detail (between 0 and CHUNK_N_LODS - 1) of the loaded chunk with the
+		* specified chunk position. With an infinite world, the chunk management thread sets it back
+		* to the level of detail given by the chunk's distance to the player when it updates the chunk.
+		*/
+		static void setChunkLOD(const vec3& chunkPos, unsigned int lod);
+
 		/**
 		* @brief Set the block ID of a specfied block position.
 		*/
@@ -569,6 +2005,20 @@ namespace VoxelEng {
 		*/
 		static block setBlock(int x, int y, int z, block blockID);
 
+		/**
+		* @brief Fills the box defined by the global positions (x1, y1, z1) and (x2, y2, z2)
+		* (both included) with the specified block ID.
+		* Each affected chunk is locked and updated only once.
+		*/
+		static void fillBox(int x1, int y1, int z1, int x2, int y2, int z2, block blockID);
+
+		/**
+		* @brief Applies all the specified block modifications.
+		* Consecutive modifications that affect the same chunk are applied
+		* locking and updating said chunk only once.
+		*/
+		static void setBlocks(std::span<const worldBlockEdit> edits);
+
 		/**
 		* @brief Returns pointer to the created chunk.
 		*/
@@ -593,82 +2043,93 @@ namespace VoxelEng {
 
 		/**
 		* @brief Select a chunk with the specified chunk position.
-		* WARNING. Not meant for use in AI mode.
+		* WARNING. Not meant for use in AI mode. The returned chunk can be unloaded and reused at any moment
+		* unless the calling thread holds a chunkReadGuard that was created before calling this method.
 		*/
 		static chunk* selectChunk(int x, int y, int z);
 
 		/**
 		* @brief Select a chunk with the specified chunk position.
-		* WARNING. Not meant for use in AI mode.
+		* WARNING. Not meant for use in AI mode. The returned chunk can be unloaded and reused at any moment
+		* unless the calling thread holds a chunkReadGuard that was created before calling this method.
 		*/
 		static chunk* selectChunkByChunkPos(const vec3& chunkPos);
 
 		/**
 		* @brief Select a chunk with the specified block position.
-		* WARNING. Not meant for use in AI mode.
+		* WARNING. Not meant for use in AI mode. The returned chunk can be unloaded and reused at any moment
+		* unless the calling thread holds a chunkReadGuard that was created before calling this method.
 		*/
 		static chunk* selectChunkByChunkPos(int x, int y, int z);
 
 		/**
 		* @brief Select a chunk with the specified global position.
-		* WARNING. Not meant for use in AI mode.
+		* WARNING. Not meant for use in AI mode. The returned chunk can be unloaded and reused at any moment
+		* unless the calling thread holds a chunkReadGuard that was created before calling this method.
 		*/
 		static chunk* selectChunkByRealPos(const vec3& pos);
 
 		/**
 		* @brief Select the neighbor -X chunk for the chunk with the specified chunk position
-		* WARNING. Not meant for use in AI mode.
+		* WARNING. Not meant for use in AI mode. The returned chunk can be unloaded and reused at any moment
+		* unless the calling thread holds a chunkReadGuard that was created before calling this method.
 		*/
 		static chunk* neighborMinusX(const vec3& chunkPos);
 
 		/**
 		* @brief Select the neighbor +X chunk for the chunk with the specified chunk position
-		* WARNING. Not meant for use in AI mode.
+		* WARNING. Not meant for use in AI mode. The returned chunk can be unloaded and reused at any moment
+		* unless the calling thread holds a chunkReadGuard that was created before calling this method.
 		*/
 		static chunk* neighborPlusX(const vec3& chunkPos);
 
 		/**
 		* @brief Select the neighbor -Y chunk for the chunk with the specified chunk position
-		* WARNING. Not meant for use in AI mode.
+		* WARNING. Not meant for use in AI mode. The returned chunk can be unloaded and reused at any moment
+		* unless the calling thread holds a chunkReadGuard that was created before calling this method.
 		*/
 		static chunk* neighborMinusY(const vec3& chunkPos);
 
 		/**
 		* @brief Select the neighbor +Y chunk for the chunk with the specified chunk position
-		* WARNING. Not meant for use in AI mode.
+		* WARNING. Not meant for use in AI mode. The returned chunk can be unloaded and reused at any moment
+		* unless the calling thread holds a chunkReadGuard that was created before calling this method.
 		*/
 		static chunk* neighborPlusY(const vec3& chunkPos);
 
 		/**
 		* @brief Select the neighbor -Z chunk for the chunk with the specified chunk position
-		* WARNING. Not meant for use in AI mode.
+		* WARNING. Not meant for use in AI mode. The returned chunk can be unloaded and reused at any moment
+		* unless the calling thread holds a chunkReadGuard that was created before calling this method.
 		*/
 		static chunk* neighborMinusZ(const vec3& chunkPos);
 
 		/**
 		* @brief Select the neighbor +Z chunk for the chunk with the specified chunk position
-		* WARNING. Not meant for use in AI mode.
+		* WARNING. Not meant for use in AI mode. The returned chunk can be unloaded and reused at any moment
+		* unless the calling thread holds a chunkReadGuard that was created before calling this method.
 		*/
 		static chunk* neighborPlusZ(const vec3& chunkPos);
 
 		/**
-		* @brief Returns the system's writeable chunk vertex data. That is,
-		* it returns the system's chunk vertex data that can be modified by the chunk
-		* management thread and chunk meshing threads and that it is not safe for
-		* reading.
+		* @brief Returns the changes to the drawable chunks that have not been handed to the
+		* rendering thread yet. A null mesh means that the chunk must no longer be drawn.
+		* These changes can be modified by the chunk management thread and chunk meshing
+		* threads and they are not safe for reading.
 		* WARNING. This operation is not thread-safe.
 		* To push back a chunk's rendering data into this deque,
 		* use chunkManager::pushDrawableChunks(...) method to prevent
 		* race conditions when using multiple threads in the
 		* chunk management system.
 		*/
-		static std::unordered_map<vec3, std::vector<vertex>>* drawableChunksWrite();
+		static std::unordered_map<vec3, chunkMesh>* drawableChunksWrite();
 
 		/**
-		* @brief Returns the mutex that guards the registered chunks dictionary.
+		* @brief Returns the reader-writer mutex that guards the registered chunks dictionary.
+		* Only chunk loading and unloading lock it in exclusive mode.
 		* WARNING. Not meant for use in AI mode.
 		*/
-		static std::recursive_mutex& chunksMutex();
+		static std::shared_mutex& chunksMutex();
 
 		/**
 		* @brief Returns the mutex that guards the chunk high priority update list.
@@ -715,21 +2176,28 @@ namespace VoxelEng {
 		static void waitTerrainLoaded();
 
 		/**
-		* @brief Atomically pushes back a chunk's rendering data into the write drawable chunks deque.
+		* @brief Atomically publishes a chunk's new mesh into the drawable chunks changes.
+		* Only chunks whose mesh changed need to be published, as the rendering thread keeps
+		* drawing the rest of chunks with the meshes it already has.
+		* If the chunk has no mesh, it will no longer be drawn. Meshes without vertices are
+		* published too, as their face connectivity tells which chunks they hide.
 		*/
 		static void pushDrawableChunks(const chunkRenderingData& renderingData);
 
 		/**
-		* @brief Swaps the buffers of chunks' vertices. The one used for reading in the renderer thread becomes
-		* the one used for writing in the chunk manager thread and vice versa.
-		* Sets the meshes updated flag to false and should be called only if it is set to true (check
-		* with chunkManager::meshesUpdated().
+		* @brief Atomically publishes that the chunk at chunk position 'chunkPos' must no longer be drawn.
+		*/
+		static void removeDrawableChunk(const vec3& chunkPos);
+
+		/**
+		* @brief Applies the drawable chunks changes to the drawable chunks used by the renderer thread
+		* and clears them.
 		* WARNING. ONLY CALL THIS METHOD WHEN THE RENDERER THREAD AND THE CHUNK MANAGER THREAD ARE SYNCED.
 		*/
-		static void swapDrawableChunksLists();
+		static void updateDrawableChunks();
 
 		/**
-		* @brief Update vertex data of all chunks that have a pending hign priority update.
+		* @brief Applies the drawable chunks changes of all chunks that have a pending hign priority update.
 		* WARNING. ONLY CALL THIS METHOD WHEN THE RENDERER THREAD AND THE CHUNK MANAGER THREAD ARE SYNCED.
 		*/
 		static void updatePriorityChunks();
@@ -750,19 +2218,12 @@ namespace VoxelEng {
 		*/
 		static void unloadChunk(const vec3& chunkPos);
 
-		/**
-		* @brief Function called by meshing threads to generate
-		* meshes for chunks that are close to the player.
-		*/
-		static void meshChunks(const std::atomic<int>& chunkRange, int rangeStart, int rangeEnd,
-						       std::shared_mutex& syncMutex, std::condition_variable_any& meshingThreadsCV,
-						       std::atomic<bool>& meshingTsCVFlag, std::barrier<>& syncPoint);
-
 		/**
 		* @brief Function called by the chunk management thread to use with infinite world types.
-		* It coordinates all meshing threads and manages the chunk unloading process
-		* in order to prevent any race condition between said threads, among other things
-		* such as synchronization and data transfering with the rendering thread.
+		* It hands the loading, meshing and unloading of chunks to a work-stealing scheduler with
+		* 'nMeshingThreads' threads and keeps unloading apart from the other tasks in order to
+		* prevent any race condition between them, among other things such as synchronization
+		* and data transfering with the rendering thread.
 		* WARNING. CURRENTLY NOT TESTED, ONLY PROOF OF CONCEPT.
 		*/
 		static void manageChunks(unsigned int nMeshingThreads);
@@ -866,15 +2327,16 @@ namespace VoxelEng {
 					infiniteWorld_;
 		static int nChunksToCompute_;
 		static std::unordered_map<vec3, chunk*> chunks_;
-		static std::unordered_map<vec3, model>* drawableChunksWrite_,
+		static std::unordered_map<vec3, chunkMesh>* drawableChunksWrite_,
 															* drawableChunksRead_;
-		static std::deque<chunk*> freeChunks_;
 		static std::unordered_set<vec3> freeableChunks_;
 	
 		static std::deque<vec3> priorityMeshingList_; // Chunks that need a high priority mesh regeneration.
 		static std::deque<vec3> priorityUpdateList_; // Chunks that, once their mesh is updated, need to update their vertex data.
+		static std::priority_queue<chunkMeshingJob> meshingJobs_; // Chunks that need to be loaded or meshed with an infinite world.
 
 		static std::mutex freeableChunksMutex_,
+						  meshingJobsMutex_,
 			              managerThreadMutex_,
 						  loadingTerrainMutex_;
 
@@ -885,14 +2347,29 @@ namespace VoxelEng {
 		*/
 		static std::shared_mutex highPriorityMutex_;
 
+		/*
+		Guards the chunks dictionary and the chunk grid. Only chunk loading and
+		unloading lock it in exclusive mode. Lookups that hit the chunk grid or
+		follow neighbor links do not lock it at all.
+		*/
+		static std::shared_mutex chunksMutex_;
+
+		/*
+		Guards the AI agents' chunk copies.
+		*/
+		static std::shared_mutex AIChunksMutex_;
+
 		static std::recursive_mutex drawableChunksWriteMutex_,
-						            chunksMutex_,
-						            freeChunksMutex_,
 						            priorityMeshingListMutex_;
 		static std::condition_variable managerThreadCV_,
 									   loadingTerrainCV_;
 		static std::condition_variable_any highPriorityUpdatesCV_;
 
+		/*
+		Distance (in chunks) to the player from which chunks are meshed at each level of detail.
+		*/
+		static std::atomic<unsigned int> lodDistances_[CHUNK_N_LODS];
+
 		/*
 		Used to force all meshing threads to synchronize with
 		the rendering thread when a high priority
@@ -912,12 +2389,148 @@ namespace VoxelEng {
 
 		static bool originalWorldAccess_;
 
+		/*
+		Primary chunk lookup structure. Registered chunks are stored both in 'chunks_'
+		and, if their slot is free, in the chunk grid. Chunks whose slot was already taken
+		are only stored in 'chunks_' and counted in 'nOutOfGridChunks_', so lookups that
+		miss the grid only need to search 'chunks_' while that counter is not zero.
+		Grids replaced because of a change in the number of chunks to compute are retired
+		instead of freed, as lock-free readers may still be using them.
+		*/
+		static std::atomic<chunkGrid*> chunkGrid_;
+		static std::vector<chunkGrid*> retiredChunkGrids_;
+		static std::atomic<unsigned int> nOutOfGridChunks_;
+
 
 		/*
 		Methods.
 		*/
+
+		/*
+		Get the ID of the block at the specified position of the original world.
+		WARNING. The calling thread must hold a chunkReadGuard.
+		*/
 		static block getBlockOGWorld_(int posX, int posY, int posZ);
 
+		/*
+		Returns the chunk that block reads at the specified chunk position should access,
+		taking into account the currently selected AI agent world if AI mode is enabled.
+		Returns nullptr if there is no such chunk.
+		WARNING. Does not lock 'AIChunksMutex_'.
+		*/
+		static chunk* selectChunkForRead_(const vec3& chunkPos);
+
+		/*
+		Returns the chunk that block modifications at the specified chunk position should access,
+		creating the selected AI agent's copy of said chunk if AI mode is enabled and it does not exist yet.
+		Returns nullptr if there is no such chunk.
+		WARNING. Does not lock 'AIChunksMutex_'.
+		*/
+		static chunk* selectChunkForWrite_(const vec3& chunkPos);
+
+		/*
+		Returns the index of the chunk grid's slot associated with the specified chunk position
+		or -1 if said position is outside the chunk grid's bounds.
+		*/
+		static int chunkGridSlot_(const chunkGrid* grid, const vec3& chunkPos);
+
+		/*
+		Returns the registered chunk with the specified chunk position or nullptr if there is not any.
+		Lookups that hit the chunk grid do not lock 'chunksMutex_'. The rest lock it in shared mode.
+		*/
+		static chunk* findChunk_(const vec3& chunkPos);
+
+		/*
+		Returns the registered chunk with the specified chunk position or nullptr if there is not any.
+		WARNING. Does not lock 'chunksMutex_'.
+		*/
+		static chunk* lookUpChunk_(const vec3& chunkPos);
+
+		/*
+		Returns the neighbor chunk in the specified direction of the chunk with the specified chunk position.
+		The neighbor links of said chunk are used if it is loaded.
+		*/
+		static chunk* neighbor_(const vec3& chunkPos, blockViewDir direction);
+
+		/*
+		Links the specified chunk with its loaded neighbors and vice versa.
+		WARNING. Does not lock 'chunksMutex_'.
+		*/
+		static void linkNeighbors_(chunk* selectedChunk);
+
+		/*
+		Sets the level of detail of the specified chunk. If it changes, the chunk and the borders
+		of its neighbors with it are marked to have their meshes regenerated.
+		*/
+		static void setChunkLOD_(chunk* selectedChunk, unsigned int lod);
+
+		/*
+		Removes the links between the specified chunk and its neighbors.
+		WARNING. Does not lock 'chunksMutex_'.
+		*/
+		static void unlinkNeighbors_(chunk* selectedChunk);
+
+		/*
+		Registers the specified chunk with the specified chunk position and returns it.
+		If another chunk is already registered with said position, the specified chunk is
+		released to the chunk pool and the registered one is returned instead.
+		*/
+		static chunk* registerChunk_(const vec3& chunkPos, chunk* selectedChunk);
+
+		/*
+		Unregisters the chunk with the specified chunk position (if any).
+		Returns the unregistered chunk or nullptr if there was not any.
+		*/
+		static chunk* unregisterChunk_(const vec3& chunkPos);
+
+		/*
+		Queues the loading and meshing jobs of the chunks within the player's range, prioritised
+		by their distance to the player's camera and whether they are in its view. Chunks within
+		range are unmarked as freeable.
+		WARNING. Must be called when all meshing threads are synced with the chunk management thread.
+		*/
+		static void queueMeshingJobs_();
+
+		/*
+		Pops the meshing job with the highest priority into 'job'.
+		Returns false if there are no jobs left.
+		*/
+		static bool popMeshingJob_(chunkMeshingJob& job);
+
+		/*
+		Loads or meshes the chunk of the specified job unless 'deadline' has passed
+		or a high priority chunk update has been issued.
+		*/
+		static void runMeshingJob_(const chunkMeshingJob& job, const timePoint& deadline);
+
+		/*
+		Same as unregisterChunk_ but without locking.
+		WARNING. Does not lock 'chunksMutex_'.
+		*/
+		static chunk* removeChunk_(const vec3& chunkPos);
+
+		/*
+		Rebuilds the chunk grid if its size does not correspond to the current number of chunks to compute.
+		WARNING. Does not lock 'chunksMutex_'.
+		*/
+		static void resizeChunkGrid_();
+
+		/*
+		Returns the chunk grid's width for the current number of chunks to compute.
+		*/
+		static int chunkGridWidth_();
+
+		/*
+		Reserves enough chunk pool capacity to hold as many chunks as the chunk grid.
+		*/
+		static void reserveChunkPool_();
+
+		/*
+		Removes all chunks from the chunk grid.
+		WARNING. Does not lock 'chunksMutex_'.
+		*/
+		static void clearChunkGrid_();
+
 	};
 
 	inline bool chunkManager::initialised() {
@@ -986,13 +2599,13 @@ namespace VoxelEng {
 
 	}
 
-	inline std::unordered_map<vec3, std::vector<vertex>> const * chunkManager::drawableChunksRead() {
+	inline std::unordered_map<vec3, chunkMesh> const * chunkManager::drawableChunksRead() {
 
 		return drawableChunksRead_;
 
 	}
 
-	inline std::unordered_map<vec3, std::vector<vertex>>* chunkManager::drawableChunksWrite() {
+	inline std::unordered_map<vec3, chunkMesh>* chunkManager::drawableChunksWrite() {
 
 		return drawableChunksWrite_;
 
@@ -1093,7 +2706,7 @@ namespace VoxelEng {
 
 	}
 
-	inline std::recursive_mutex& chunkManager::chunksMutex() {
+	inline std::shared_mutex& chunkManager::chunksMutex() {
 
 		return chunksMutex_;
 
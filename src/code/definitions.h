@@ -67,6 +67,11 @@ namespace VoxelEng {
 	*/
 	const int SCZ = 16;
 
+	/**
+	* @brief Total number of blocks in a chunk.
+	*/
+	const int N_CHUNK_BLOCKS = SCX * SCY * SCZ;
+
 	/**
 	* @brief Default width for a game window.
 	*/
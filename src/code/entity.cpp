@@ -56,6 +56,8 @@ namespace VoxelEng {
         vec3 blockPos;
         selectedBlock_ = 0;
 
+        // The whole ray is read under a single guard so that each step does not announce a new read.
+        chunkReadGuard guard;
         while (step < blockReachRange_ && !selectedBlock_) {
 
             selectedBlockPos_ = pos + (dir * step);
@@ -92,8 +94,7 @@ namespace VoxelEng {
 
         if (!GUImanager::levelGUIOpened()) {
 
-            std::unique_lock<std::recursive_mutex> lock(chunkManager::chunksMutex());
-
+            chunkReadGuard guard; // The selected chunk cannot be reused while it is being edited.
             chunk* selectedChunk = chunkManager::selectChunkByRealPos(selectedBlockPos_),
                  * neighbor = nullptr;
 
@@ -159,6 +160,7 @@ namespace VoxelEng {
 
             if (chunkManager::isInWorld(xOld, yOld, zOld) && !chunkManager::getBlock(xOld, yOld, zOld)) {
             
+                chunkReadGuard guard; // The selected chunk cannot be reused while it is being edited.
                 chunk* selectedChunk = chunkManager::selectChunkByChunkPos(xOld, yOld, zOld),
                      * neighbor = nullptr;
 
@@ -441,7 +443,7 @@ namespace VoxelEng {
          entityManager::firstManagementIteration_ = true;
     std::vector<entity> entityManager::entities_;
     std::vector<batch> entityManager::batches_;
-    std::vector<model>* entityManager::renderingDataWrite_ = nullptr,
+    std::vector<batchRenderingData>* entityManager::renderingDataWrite_ = nullptr,
                       * entityManager::renderingDataRead_ = nullptr;
     std::unordered_set<unsigned int> entityManager::activeEntityID_,
                                      entityManager::activeBatchID_,
@@ -472,9 +474,9 @@ namespace VoxelEng {
             if (!game::AImodeON()) {
             
                 if (!renderingDataWrite_)
-                    renderingDataWrite_ = new std::vector<model>();
+                    renderingDataWrite_ = new std::vector<batchRenderingData>();
                 if (!renderingDataRead_)
-                    renderingDataRead_ = new std::vector<model>();
+                    renderingDataRead_ = new std::vector<batchRenderingData>();
             
             }
             
@@ -543,10 +545,10 @@ namespace VoxelEng {
         else {
 
             if (!renderingDataWrite_)
-                renderingDataWrite_ = new std::vector<model>();
+                renderingDataWrite_ = new std::vector<batchRenderingData>();
 
             if (!renderingDataRead_)
-                renderingDataRead_ = new std::vector<model>();
+                renderingDataRead_ = new std::vector<batchRenderingData>();
         
         }
     
@@ -587,9 +589,12 @@ namespace VoxelEng {
             if (batches_[i].isDirty()) {
                     
                 if (renderingDataWrite_->size() <= i)
-                    renderingDataWrite_->push_back(batches_[i].generateVertices());
-                else
-                    renderingDataWrite_->operator[](i) = batches_[i].generateVertices();
+                    renderingDataWrite_->push_back(batchRenderingData());
+
+                batchRenderingData& renderingData = renderingDataWrite_->operator[](i);
+                renderingData.vertices = batches_[i].generateVertices();
+                renderingData.boxMin = batches_[i].boxMin();
+                renderingData.boxMax = batches_[i].boxMax();
                 synchronise = true;
                     
             }  
@@ -805,7 +810,7 @@ namespace VoxelEng {
 
     void entityManager::swapReadWrite() {
 
-        std::vector<model>* aux = renderingDataRead_;
+        std::vector<batchRenderingData>* aux = renderingDataRead_;
 
         renderingDataRead_ = renderingDataWrite_;
         renderingDataWrite_ = aux;
@@ -40,6 +40,7 @@ namespace VoxelEng {
 	/////////////////////////
 
 	class batch;
+	struct batchRenderingData;
 	class entityManager;
 
 
@@ -632,7 +633,7 @@ namespace VoxelEng {
 		/**
 		* @brief Get the readable rendering data necessary for the rendering thread to render the batches properly.
 		*/
-		static const std::vector<model>* renderingData();
+		static const std::vector<batchRenderingData>* renderingData();
 
 
 		// Modifiers: actions on entities.
@@ -677,8 +678,8 @@ namespace VoxelEng {
 		// to execute.
 		static std::list<unsigned int> tickingEntityID_; 	
 
-		static std::vector <model>* renderingDataWrite_,
-						          * renderingDataRead_;
+		static std::vector<batchRenderingData>* renderingDataWrite_,
+		                                      * renderingDataRead_;
 		
 		static std::recursive_mutex entitiesMutex_,
 									batchesMutex_;
@@ -772,7 +773,7 @@ namespace VoxelEng {
 	
 	}
 
-	inline const std::vector<model>* entityManager::renderingData() {
+	inline const std::vector<batchRenderingData>* entityManager::renderingData() {
 	
 		return renderingDataRead_;
 	
@@ -1,10 +1,12 @@
 #include "game.h"
+#include <algorithm>
 #include <barrier>
 #include <deque>
 #include <functional>
 #include <fstream>
 #include <string>
 #include <shared_mutex>
+#include <thread>
 #include <vector>
 #include <unordered_set>
 #include <unordered_map>
@@ -25,6 +27,7 @@
 #include "vertex.h"
 #include "definitions.h"
 #include "shader.h"
+#include "terrainRenderer.h"
 #include "texture.h"
 #include "graphics.h"
 #include "gui.h"
@@ -64,7 +67,9 @@ namespace VoxelEng {
 
     unsigned int game::saveSlot_ = 0,
                  game::blockReachRange_ = 5,
-                 game::nMeshingThreads_ = 1;
+                 game::nMeshingThreads_ = std::max(std::thread::hardware_concurrency(), 3u) - 2,
+                 game::nDrawnBatches_ = 0,
+                 game::nCulledBatches_ = 0;
     float game::FOV_ = 110.0f,
           game::zNear_ = 0.1f,
           game::zFar_ = 500.0f;
@@ -75,8 +80,7 @@ namespace VoxelEng {
 
     texture* game::blockTextureAtlas_ = nullptr;
 
-    std::unordered_map<vec3, std::vector<vertex>> const* game::chunksToDraw_ = nullptr;
-    const std::vector<model>* game::batchesToDraw_ = nullptr;
+    const std::vector<batchRenderingData>* game::batchesToDraw_ = nullptr;
 
     shader* game::defaultShader_ = nullptr;
     vertexBuffer* game::vbo_ = nullptr;
@@ -130,7 +134,7 @@ namespace VoxelEng {
 
             saveSlot_ = 0,
             blockReachRange_ = 5,
-            nMeshingThreads_ = 1;
+            nMeshingThreads_ = std::max(std::thread::hardware_concurrency(), 3u) - 2; // Leave the rendering and chunk management threads their own cores.
             
             FOV_ = 110.0f,
             zNear_ = 0.1f,
@@ -275,6 +279,9 @@ namespace VoxelEng {
             layout_->push<GLfloat>(2);
             layout_->push<normalVec>(1);
 
+            // Chunks' meshes are drawn by the terrain rendering system.
+            terrainRenderer::init();
+
 
             // Bind the currently used VAO, shaders and atlases for 3D rendering.
             va_->bind();
@@ -494,6 +501,7 @@ namespace VoxelEng {
             vec3 lightpos(10.0f, 150.0f, -10.0f);
             defaultShader_->setUniformVec3f("u_sunLightPos", lightpos);
             defaultShader_->setUniform1i("u_useComplexLighting", 0);
+            defaultShader_->setUniform1i("u_blockAtlasResolution", texture::blockAtlasResolution());
 
             // Time/FPS related stuff.
             double lastSecondTime = glfwGetTime(), // How much time has passed since the last second passed.
@@ -544,12 +552,12 @@ namespace VoxelEng {
 
                     if (chunkManager::forceSyncFlag())
                         chunkManager::updatePriorityChunks();
-                    else {
-
-                        chunkManager::swapDrawableChunksLists();
-                        chunksToDraw_ = chunkManager::drawableChunksRead();
+                    else
+                        chunkManager::updateDrawableChunks();
 
-                    }
+                    // Chunk meshes only change when the threads are synced,
+                    // so they only need to be uploaded to the GPU here.
+                    terrainRenderer::updateMeshes(*chunkManager::drawableChunksRead());
 
                     chunkManager::managerThreadMutex().unlock();
                     chunkManager::managerThreadCV().notify_one();
@@ -567,39 +575,33 @@ namespace VoxelEng {
 
                 }
 
+                // Render chunks.
+                terrainRenderer::draw(*renderer_, *defaultShader_, *playerCamera_);
+
                 // Binding section.
                 va_->bind();
                 vbo_->bind();
-                
-                // Render chunks.
-                if (chunksToDraw_) {
-
-                    // chunk.first refers to the chunk's postion.
-                    // chunk.second refers to the chunk's vertex data.
-                    for (auto const& chunk : *chunksToDraw_) {
-
-                        if (nVertices = chunk.second.size()) {
 
-                            vbo_->prepareStatic(chunk.second.data(), sizeof(vertex) * nVertices);
-
-                            renderer_->draw3D(nVertices);
-
-                        }
+                // Render the batches inside the view frustum.
+                nDrawnBatches_ = 0;
+                nCulledBatches_ = 0;
+                if (batchesToDraw_) {
 
-                    }
+                    for (auto const& batch : *batchesToDraw_) {
 
-                }
+                        if (nVertices = batch.vertices.size()) {
 
-                // Render batches.
-                if (batchesToDraw_) {
+                            if (playerCamera_->viewFrustum().intersects(batch.boxMin, batch.boxMax)) {
 
-                    for (auto const& batch : *batchesToDraw_) {
+                                vbo_->prepareStatic(batch.vertices.data(), sizeof(vertex) * nVertices);
 
-                        if (nVertices = batch.size()) {
+                                renderer_->draw3D(nVertices);
 
-                            vbo_->prepareStatic(batch.data(), sizeof(vertex) * nVertices);
+                                nDrawnBatches_++;
 
-                            renderer_->draw3D(nVertices);
+                            }
+                            else
+                                nCulledBatches_++;
 
                         }
 
@@ -633,6 +635,9 @@ namespace VoxelEng {
 
             }
 
+            // Free the level's chunk meshes in GPU memory.
+            terrainRenderer::clear();
+
         }
     
     }
@@ -978,12 +983,7 @@ namespace VoxelEng {
 
         if (playerInputThread_ && threadsExecute[0]) {
 
-            {
-
-                threadsExecute[0] = false;
-                std::unique_lock<std::recursive_mutex> lock(chunkManager::chunksMutex());
-
-            }
+            threadsExecute[0] = false;
 
             playerInputThread_->join();
             delete playerInputThread_;
@@ -1081,6 +1081,8 @@ namespace VoxelEng {
         if (layout_)
             delete layout_;
 
+        terrainRenderer::cleanUp();
+
         if (renderer_)
             delete renderer_;
 
@@ -1088,7 +1090,6 @@ namespace VoxelEng {
 
         playerCamera_ = nullptr;
 
-        chunksToDraw_ = nullptr;
         batchesToDraw_ = nullptr;
 
         graphicalModeInitialised_ = false;
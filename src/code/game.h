@@ -13,6 +13,7 @@
 #include <condition_variable>
 #include <thread>
 #include <mutex>
+#include "batch.h"
 #include "chunk.h"
 #include "definitions.h"
 #include "gameWindow.h"
@@ -119,6 +120,17 @@ namespace VoxelEng {
         */
         static bool AImodeON();
 
+        /**
+        * @brief Returns the number of entity batches drawn in the last frame.
+        */
+        static unsigned int nDrawnBatches();
+
+        /**
+        * @brief Returns the number of entity batches culled in the last frame
+        * because they were outside the player camera's view frustum.
+        */
+        static unsigned int nCulledBatches();
+
 
 		// Modifiers.
 
@@ -236,7 +248,9 @@ namespace VoxelEng {
 
         static unsigned int saveSlot_,
                             blockReachRange_,
-                            nMeshingThreads_; // Number of threads for non-high priority mesh updates with infinite world loading
+                            nMeshingThreads_, // Number of threads for non-high priority mesh updates with infinite world loading
+                            nDrawnBatches_,
+                            nCulledBatches_;
         static float FOV_,
                      zNear_,
                      zFar_;
@@ -244,8 +258,7 @@ namespace VoxelEng {
         static camera* playerCamera_;
 
         static texture* blockTextureAtlas_;
-        static std::unordered_map<vec3, std::vector<vertex>> const* chunksToDraw_;
-        static const std::vector<model>* batchesToDraw_;
+        static const std::vector<batchRenderingData>* batchesToDraw_;
         static shader* defaultShader_;
         static vertexBuffer* vbo_;
         static vertexArray* va_;
@@ -292,6 +305,18 @@ namespace VoxelEng {
 
     }
 
+    inline unsigned int game::nDrawnBatches() {
+
+        return nDrawnBatches_;
+
+    }
+
+    inline unsigned int game::nCulledBatches() {
+
+        return nCulledBatches_;
+
+    }
+
     inline void game::setSaveSlot(unsigned int slot) {
     
         saveSlot_ = slot;
@@ -7,8 +7,7 @@
 * @brief Contains the definition of the vertex index buffer class, which
 * is used to hold the indices to some vertices in order to reusem them
 * and avoid sending duplicated vertices to the GPU.
-* It is currently unused in the rest of the engine's code, but it was
-* included in case the user needs it.
+* It is currently used to share the indices of the faces of all chunk meshes.
 */
 #ifndef _VOXELENG_INDEXBUFFER_
 #define _VOXELENG_INDEXBUFFER_
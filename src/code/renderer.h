@@ -37,6 +37,15 @@ namespace VoxelEng {
 		*/
 		void draw3D(const indexBuffer& ib) const;
 
+		/**
+		* @brief Performs 'drawCount' draws with the indexBuffer object in a single draw call. The i-th draw uses
+		* the first 'nIndices[i]' indices of the buffer, which are added 'baseVertices[i]' to obtain the vertex they refer to.
+		* 'firstIndices' must point to 'drawCount' null offsets.
+		* WARNING. Must be called in a thread with valid graphics context and the index buffer and any associated buffer bust be bound properly
+		* before calling this method.
+		*/
+		void multiDraw3D(const GLsizei* nIndices, const void* const* firstIndices, const GLint* baseVertices, int drawCount) const;
+
 		/**
 		* @brief Draws 'count' model triangles into a 3D space.
 		* WARNING. Must be called in a thread with valid graphics API context.
@@ -68,6 +77,12 @@ namespace VoxelEng {
 
 	}
 
+	inline void renderer::multiDraw3D(const GLsizei* nIndices, const void* const* firstIndices, const GLint* baseVertices, int drawCount) const {
+
+		glMultiDrawElementsBaseVertex(GL_TRIANGLES, nIndices, GL_UNSIGNED_INT, firstIndices, drawCount, baseVertices);
+
+	}
+
 	inline void renderer::draw3D(int count) const {
 
 		glDrawArrays(GL_TRIANGLES, 0, count);
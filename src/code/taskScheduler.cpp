@@ -0,0 +1,135 @@
+#include "taskScheduler.h"
+#include <algorithm>
+
+
+namespace VoxelEng {
+
+    thread_local taskScheduler* taskScheduler::currentScheduler_ = nullptr;
+    thread_local unsigned int taskScheduler::currentWorker_ = 0;
+
+
+    taskScheduler::taskScheduler(unsigned int nThreads)
+    : nextWorker_(0), nQueuedTasks_(0), nPendingTasks_(0), stop_(false) {
+
+        nThreads = std::max(nThreads, 1u);
+
+        for (unsigned int i = 0; i < nThreads; i++)
+            workers_.push_back(std::make_unique<worker>());
+
+        for (unsigned int i = 0; i < nThreads; i++)
+            threads_.push_back(std::thread(&taskScheduler::runWorker_, this, i));
+
+    }
+
+    void taskScheduler::submit(std::function<void()> task) {
+
+        unsigned int workerIndex = currentScheduler_ == this ? currentWorker_ : nextWorker_++ % workers_.size();
+
+        nPendingTasks_++;
+
+        {
+
+            std::unique_lock<std::mutex> lock(workers_[workerIndex]->tasksMutex);
+            workers_[workerIndex]->tasks.push_back(std::move(task));
+
+        }
+
+        nQueuedTasks_++;
+
+        {
+
+            std::unique_lock<std::mutex> lock(stateMutex_);
+            tasksCV_.notify_one();
+
+        }
+
+    }
+
+    void taskScheduler::wait() {
+
+        std::unique_lock<std::mutex> lock(stateMutex_);
+        idleCV_.wait(lock, [this]() { return nPendingTasks_ == 0; });
+
+    }
+
+    taskScheduler::~taskScheduler() {
+
+        wait();
+
+        {
+
+            std::unique_lock<std::mutex> lock(stateMutex_);
+            stop_ = true;
+
+        }
+        tasksCV_.notify_all();
+
+        for (std::thread& thread : threads_)
+            thread.join();
+
+    }
+
+    void taskScheduler::runWorker_(unsigned int workerIndex) {
+
+        currentScheduler_ = this;
+        currentWorker_ = workerIndex;
+
+        std::function<void()> task;
+        while (true) {
+
+            if (takeTask_(workerIndex, task)) {
+
+                task();
+                task = nullptr;
+
+                // Wake up the threads waiting for all tasks to finish.
+                if (nPendingTasks_.fetch_sub(1) == 1) {
+
+                    std::unique_lock<std::mutex> lock(stateMutex_);
+                    idleCV_.notify_all();
+
+                }
+
+            }
+            else {
+
+                std::unique_lock<std::mutex> lock(stateMutex_);
+                tasksCV_.wait(lock, [this]() { return stop_ || nQueuedTasks_ > 0; });
+
+                if (stop_)
+                    break;
+
+            }
+
+        }
+
+    }
+
+    bool taskScheduler::takeTask_(unsigned int workerIndex, std::function<void()>& task) {
+
+        // Both the worker's own tasks and stolen tasks are taken from the front of the deque, which holds
+        // the deque's highest priority task. Stealing from the back would spend the spare workers on the
+        // tasks that are most likely to be skipped when their deadline is reached (see chunkManager).
+        for (unsigned int i = 0; i < workers_.size(); i++) {
+
+            worker& victim = *workers_[(workerIndex + i) % workers_.size()];
+            std::unique_lock<std::mutex> lock(victim.tasksMutex);
+
+            if (!victim.tasks.empty()) {
+
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+
+                nQueuedTasks_--;
+
+                return true;
+
+            }
+
+        }
+
+        return false;
+
+    }
+
+}
@@ -0,0 +1,129 @@
+/**
+* @file taskScheduler.h
+* @version 1.0
+* @date 17/10/2026
+* @author Abdon Crespo Alvarez
+* @title Task scheduler.
+* @brief Contains the declaration of the 'taskScheduler' class.
+*/
+#ifndef _VOXELENG_TASKSCHEDULER_
+#define _VOXELENG_TASKSCHEDULER_
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "definitions.h"
+
+namespace VoxelEng {
+
+	////////////
+	//Classes.//
+	////////////
+
+	/**
+	* @brief Runs tasks on a fixed set of worker threads with work stealing.
+	* Each worker has its own deque of tasks. Workers take tasks from the front of their own
+	* deque, so tasks submitted in order of priority keep that order, and when it is empty they
+	* steal tasks from the front of the other workers' deques, which hold their highest priority tasks.
+	*/
+	class taskScheduler {
+
+	public:
+
+		// Constructors.
+
+		/**
+		* @brief Class constructor. Starts 'nThreads' worker threads (at least one).
+		*/
+		taskScheduler(unsigned int nThreads);
+
+
+		// Observers.
+
+		/**
+		* @brief Returns the number of worker threads.
+		*/
+		unsigned int nThreads() const;
+
+
+		// Modifiers.
+
+		/**
+		* @brief Submits a task. Tasks submitted from a worker thread go to that worker's deque
+		* while the rest are distributed among the workers' deques in turns.
+		*/
+		void submit(std::function<void()> task);
+
+		/**
+		* @brief Blocks the calling thread until all submitted tasks have finished.
+		* WARNING. Must not be called from a task.
+		*/
+		void wait();
+
+
+		// Destructors.
+
+		/**
+		* @brief Waits for all submitted tasks to finish and stops the worker threads.
+		*/
+		~taskScheduler();
+
+	private:
+
+		/*
+		Attributes.
+		*/
+
+		struct worker {
+
+			std::deque<std::function<void()>> tasks;
+			std::mutex tasksMutex;
+
+		};
+
+		static thread_local taskScheduler* currentScheduler_;
+		static thread_local unsigned int currentWorker_;
+
+		std::vector<std::unique_ptr<worker>> workers_;
+		std::vector<std::thread> threads_;
+
+		std::atomic<unsigned int> nextWorker_;
+		std::atomic<std::size_t> nQueuedTasks_, // Tasks waiting in the workers' deques.
+								 nPendingTasks_; // Tasks submitted that have not finished yet.
+		std::mutex stateMutex_;
+		std::condition_variable tasksCV_,
+								idleCV_;
+		bool stop_;
+
+
+		/*
+		Methods.
+		*/
+
+		/*
+		Main loop of the worker threads.
+		*/
+		void runWorker_(unsigned int workerIndex);
+
+		/*
+		Takes a task from the specified worker's deque or, if it is empty, steals one from another worker.
+		Returns false if no task could be found.
+		*/
+		bool takeTask_(unsigned int workerIndex, std::function<void()>& task);
+
+	};
+
+	inline unsigned int taskScheduler::nThreads() const {
+
+		return threads_.size();
+
+	}
+
+}
+
+#endif
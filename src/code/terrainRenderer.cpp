@@ -0,0 +1,488 @@
+#include "terrainRenderer.h"
+#include <algorithm>
+#include <cmath>
+#include "logger.h"
+#include "vertex.h"
+
+#if GRAPHICS_API == OPENGL
+
+#include <GL/glew.h>
+
+#endif
+
+
+namespace VoxelEng {
+
+    // 'terrainRenderer' class.
+
+    bool terrainRenderer::initialised_ = false;
+    std::unordered_map<vec3, terrainRenderer::gpuMesh> terrainRenderer::meshes_;
+    vertexArray* terrainRenderer::va_ = nullptr;
+    vertexBufferLayout* terrainRenderer::layout_ = nullptr;
+    indexBuffer* terrainRenderer::ibo_ = nullptr;
+    vertexBuffer* terrainRenderer::arena_ = nullptr;
+    unsigned int terrainRenderer::arenaPages_ = 0,
+                 terrainRenderer::arenaFreePages_ = 0,
+                 terrainRenderer::nDrawnChunks_ = 0,
+                 terrainRenderer::nCulledChunks_ = 0;
+    std::map<unsigned int, unsigned int> terrainRenderer::freeRuns_;
+    std::vector<float> terrainRenderer::pageOrigins_;
+    GLuint terrainRenderer::pageOriginsBuffer_ = 0,
+           terrainRenderer::pageOriginsTexture_ = 0;
+    std::vector<GLsizei> terrainRenderer::drawNIndices_;
+    std::vector<GLint> terrainRenderer::drawBaseVertices_;
+    std::vector<const void*> terrainRenderer::drawFirstIndices_;
+    vec3 terrainRenderer::minChunkPos_ = vec3Zero,
+         terrainRenderer::maxChunkPos_ = vec3Zero;
+    std::vector<terrainRenderer::visibilityNode> terrainRenderer::visibilityQueue_;
+    std::vector<bool> terrainRenderer::visitedChunks_;
+    std::uint64_t terrainRenderer::nUploads_ = 0,
+                  terrainRenderer::nUploadedBytes_ = 0;
+
+
+    void terrainRenderer::init() {
+
+        if (initialised_)
+            logger::errorLog("Terrain rendering system is already initialised");
+        else {
+
+            va_ = new vertexArray();
+            layout_ = new vertexBufferLayout();
+            ibo_ = new indexBuffer();
+            arena_ = new vertexBuffer();
+
+            // Chunks' meshes use their own packed vertex format (see 'chunkVertex'),
+            // which is read from the attribute that follows the ones of the 'vertex' struct.
+            layout_->push<unsigned int>(2);
+
+            // All chunk meshes are drawn with the same quad indices, so a face's 4 vertices
+            // are shared between its 2 triangles. Each mesh is drawn with a base vertex equal to
+            // its offset in the arena. The index buffer is bound to the VAO here.
+            std::vector<unsigned int> quadIndices(CHUNK_MAX_FACES * CHUNK_INDICES_PER_FACE);
+            for (unsigned int face = 0, firstVertex = 0; face < CHUNK_MAX_FACES; face++, firstVertex += CHUNK_VERTICES_PER_FACE) {
+
+                quadIndices[face * CHUNK_INDICES_PER_FACE] = firstVertex;
+                quadIndices[face * CHUNK_INDICES_PER_FACE + 1] = firstVertex + 1;
+                quadIndices[face * CHUNK_INDICES_PER_FACE + 2] = firstVertex + 2;
+                quadIndices[face * CHUNK_INDICES_PER_FACE + 3] = firstVertex + 2;
+                quadIndices[face * CHUNK_INDICES_PER_FACE + 4] = firstVertex + 1;
+                quadIndices[face * CHUNK_INDICES_PER_FACE + 5] = firstVertex + 3;
+
+            }
+            va_->bind();
+            ibo_->prepareStatic(quadIndices.data(), quadIndices.size());
+
+            arenaPages_ = TERRAIN_ARENA_INITIAL_PAGES;
+            arenaFreePages_ = arenaPages_;
+            freeRuns_.clear();
+            freeRuns_[0] = arenaPages_;
+
+            arena_->bind();
+            arena_->prepareDynamic(arenaPages_ * TERRAIN_ARENA_PAGE_SIZE * sizeof(chunkVertex));
+            va_->addLayout(*layout_, 3);
+            va_->unbind();
+
+            // The chunk origins are read by the vertex shader from a buffer texture with one texel per arena page.
+            pageOrigins_.assign(arenaPages_ * 4, 0.0f);
+
+            glGenBuffers(1, &pageOriginsBuffer_);
+            glBindBuffer(GL_TEXTURE_BUFFER, pageOriginsBuffer_);
+            glBufferData(GL_TEXTURE_BUFFER, pageOrigins_.size() * sizeof(float), pageOrigins_.data(), GL_DYNAMIC_DRAW);
+
+            glGenTextures(1, &pageOriginsTexture_);
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_BUFFER, pageOriginsTexture_);
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, pageOriginsBuffer_);
+            glActiveTexture(GL_TEXTURE0);
+
+            nUploads_ = 0;
+            nUploadedBytes_ = 0;
+
+            initialised_ = true;
+
+        }
+
+    }
+
+    void terrainRenderer::updateMeshes(const std::unordered_map<vec3, chunkMesh>& drawableChunks) {
+
+        // Free the meshes of the chunks that are no longer drawable.
+        for (auto it = meshes_.begin(); it != meshes_.end();)
+            if (drawableChunks.contains(it->first))
+                it++;
+            else {
+
+                freePages_(it->second.firstPage, it->second.nPages);
+                it = meshes_.erase(it);
+
+            }
+
+        // Upload the new chunk meshes.
+        for (auto const& chunk : drawableChunks) {
+
+            auto it = meshes_.find(chunk.first);
+            if (it == meshes_.end())
+                it = meshes_.insert({ chunk.first, gpuMesh{ 0, 0, 0, 0, CHUNK_ALL_FACES_CONNECTED } }).first;
+
+            gpuMesh& mesh = it->second;
+            if (mesh.version != chunk.second->version) {
+
+                if (mesh.nPages) {
+
+                    freePages_(mesh.firstPage, mesh.nPages);
+                    mesh.nPages = 0; // So that the mesh is not moved if the arena gets defragmented.
+
+                }
+
+                mesh.version = chunk.second->version;
+                mesh.faceConnectivity = chunk.second->faceConnectivity;
+                mesh.nVertices = chunk.second->vertices.size();
+
+                // Meshes without vertices are only kept for their face connectivity.
+                if (mesh.nVertices) {
+
+                    unsigned int nPages = (mesh.nVertices + TERRAIN_ARENA_PAGE_SIZE - 1) / TERRAIN_ARENA_PAGE_SIZE;
+                    mesh.firstPage = allocatePages_(nPages);
+                    mesh.nPages = nPages;
+
+                    arena_->bind();
+                    arena_->replaceDynamicData(chunk.second->vertices.data(), sizeof(chunkVertex) * mesh.nVertices,
+                                               sizeof(chunkVertex) * TERRAIN_ARENA_PAGE_SIZE * mesh.firstPage);
+                    setPageOrigins_(mesh.firstPage, mesh.nPages, vec3(chunk.first.x * SCX, chunk.first.y * SCY, chunk.first.z * SCZ));
+
+                    nUploads_++;
+                    nUploadedBytes_ += sizeof(chunkVertex) * mesh.nVertices;
+
+                }
+
+            }
+
+        }
+
+        // Update the bounds of the region the visibility traversal explores.
+        if (!meshes_.empty()) {
+
+            minChunkPos_ = meshes_.begin()->first;
+            maxChunkPos_ = minChunkPos_;
+            for (auto const& mesh : meshes_) {
+
+                minChunkPos_ = glm::min(minChunkPos_, mesh.first);
+                maxChunkPos_ = glm::max(maxChunkPos_, mesh.first);
+
+            }
+
+        }
+
+    }
+
+    void terrainRenderer::draw(const renderer& graphicsRenderer, shader& chunkShader, const camera& viewCamera) {
+
+        // Steps to the neighbor chunk across each face (in the order used by 'chunkMeshData::faceConnectivity').
+        // The opposite of face i is face i ^ 1.
+        const vec3 faceSteps[6] = { vec3(0, 0, 1), vec3(0, 0, -1), vec3(0, 1, 0), vec3(0, -1, 0), vec3(1, 0, 0), vec3(-1, 0, 0) };
+        const frustum& viewFrustum = viewCamera.viewFrustum();
+        vec3 cameraChunkPos(std::floor(viewCamera.pos().x / SCX), std::floor(viewCamera.pos().y / SCY), std::floor(viewCamera.pos().z / SCZ)),
+             regionSize = maxChunkPos_ - minChunkPos_ + vec3(1, 1, 1);
+        unsigned int nMeshes = 0;
+
+        drawNIndices_.clear();
+        drawBaseVertices_.clear();
+
+        for (auto const& mesh : meshes_)
+            if (mesh.second.nVertices)
+                nMeshes++;
+
+        if (nMeshes && (glm::any(glm::lessThan(cameraChunkPos, minChunkPos_)) || glm::any(glm::greaterThan(cameraChunkPos, maxChunkPos_)))) {
+
+            // Without a chunk to start the traversal from, only the view frustum is used to cull chunks.
+            for (auto const& mesh : meshes_)
+                if (mesh.second.nVertices) {
+
+                    vec3 chunkMin = mesh.first * vec3(SCX, SCY, SCZ);
+                    if (viewFrustum.intersects(chunkMin, chunkMin + vec3(SCX, SCY, SCZ)))
+                        addDraw_(mesh.second);
+
+                }
+
+        }
+        else if (nMeshes) {
+
+            visitedChunks_.assign(regionSize.x * regionSize.y * regionSize.z, false);
+            visibilityQueue_.clear();
+
+            visibilityQueue_.push_back(visibilityNode{ cameraChunkPos, 6, 0 });
+            vec3 offset = cameraChunkPos - minChunkPos_;
+            visitedChunks_[(offset.x * regionSize.y + offset.y) * regionSize.z + offset.z] = true;
+
+            for (std::size_t next = 0; next < visibilityQueue_.size(); next++) {
+
+                visibilityNode node = visibilityQueue_[next];
+                auto it = meshes_.find(node.chunkPos);
+                const gpuMesh* mesh = (it == meshes_.end()) ? nullptr : &it->second;
+
+                if (mesh && mesh->nVertices)
+                    addDraw_(*mesh);
+
+                for (unsigned int face = 0; face < 6; face++) {
+
+                    // Never step back towards the camera, and only leave the chunk through
+                    // a face connected to the one it was entered from.
+                    if (node.directions & (1u << (face ^ 1)))
+                        continue;
+
+                    if (mesh && node.entryFace < 6 && !((mesh->faceConnectivity >> (node.entryFace * 6 + face)) & 1))
+                        continue;
+
+                    vec3 neighborPos = node.chunkPos + faceSteps[face];
+                    if (glm::any(glm::lessThan(neighborPos, minChunkPos_)) || glm::any(glm::greaterThan(neighborPos, maxChunkPos_)))
+                        continue;
+
+                    offset = neighborPos - minChunkPos_;
+                    std::size_t neighborIndex = (offset.x * regionSize.y + offset.y) * regionSize.z + offset.z;
+                    if (visitedChunks_[neighborIndex])
+                        continue;
+                    visitedChunks_[neighborIndex] = true;
+
+                    vec3 chunkMin = neighborPos * vec3(SCX, SCY, SCZ);
+                    if (viewFrustum.intersects(chunkMin, chunkMin + vec3(SCX, SCY, SCZ)))
+                        visibilityQueue_.push_back(visibilityNode{ neighborPos, face ^ 1, node.directions | (1u << face) });
+
+                }
+
+            }
+
+        }
+
+        nDrawnChunks_ = drawNIndices_.size();
+        nCulledChunks_ = nMeshes - nDrawnChunks_;
+        if (drawFirstIndices_.size() < drawNIndices_.size())
+            drawFirstIndices_.resize(drawNIndices_.size(), nullptr);
+
+        if (!drawNIndices_.empty()) {
+
+            va_->bind();
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_BUFFER, pageOriginsTexture_);
+            glActiveTexture(GL_TEXTURE0);
+
+            chunkShader.setUniform1i("u_renderMode", 2); // renderMode = 2 stands for 3D rendering of chunks.
+            chunkShader.setUniform1i("u_chunkPageOrigins", 1);
+
+            graphicsRenderer.multiDraw3D(drawNIndices_.data(), drawFirstIndices_.data(), drawBaseVertices_.data(), drawNIndices_.size());
+
+            chunkShader.setUniform1i("u_renderMode", 0);
+
+        }
+
+    }
+
+    void terrainRenderer::resetUploadCounters() {
+
+        nUploads_ = 0;
+        nUploadedBytes_ = 0;
+
+    }
+
+    void terrainRenderer::clear() {
+
+        meshes_.clear();
+
+        freeRuns_.clear();
+        if (arenaPages_)
+            freeRuns_[0] = arenaPages_;
+        arenaFreePages_ = arenaPages_;
+
+        nDrawnChunks_ = 0;
+        nCulledChunks_ = 0;
+
+    }
+
+    void terrainRenderer::cleanUp() {
+
+        clear();
+
+        if (va_) {
+
+            delete va_;
+            va_ = nullptr;
+
+        }
+
+        if (layout_) {
+
+            delete layout_;
+            layout_ = nullptr;
+
+        }
+
+        if (ibo_) {
+
+            delete ibo_;
+            ibo_ = nullptr;
+
+        }
+
+        if (arena_) {
+
+            delete arena_;
+            arena_ = nullptr;
+
+        }
+
+        if (pageOriginsTexture_) {
+
+            glDeleteTextures(1, &pageOriginsTexture_);
+            pageOriginsTexture_ = 0;
+
+        }
+
+        if (pageOriginsBuffer_) {
+
+            glDeleteBuffers(1, &pageOriginsBuffer_);
+            pageOriginsBuffer_ = 0;
+
+        }
+
+        freeRuns_.clear();
+        pageOrigins_.clear();
+        arenaPages_ = 0;
+        arenaFreePages_ = 0;
+
+        initialised_ = false;
+
+    }
+
+    unsigned int terrainRenderer::allocatePages_(unsigned int nPages) {
+
+        if (!nPages)
+            return 0;
+
+        for (auto it = freeRuns_.begin(); it != freeRuns_.end(); it++)
+            if (it->second >= nPages) {
+
+                unsigned int firstPage = it->first,
+                             nRemainingPages = it->second - nPages;
+
+                freeRuns_.erase(it);
+                if (nRemainingPages)
+                    freeRuns_[firstPage + nPages] = nRemainingPages;
+                arenaFreePages_ -= nPages;
+
+                return firstPage;
+
+            }
+
+        // No free run is large enough. Compact the arena,
+        // doubling its capacity until the allocation fits.
+        unsigned int nArenaPages = arenaPages_,
+                     nUsedPages = arenaPages_ - arenaFreePages_;
+        while (nArenaPages - nUsedPages < nPages)
+            nArenaPages *= 2;
+        defragment_(nArenaPages);
+
+        return allocatePages_(nPages);
+
+    }
+
+    void terrainRenderer::freePages_(unsigned int firstPage, unsigned int nPages) {
+
+        if (nPages) {
+
+            arenaFreePages_ += nPages;
+
+            auto it = freeRuns_.insert({ firstPage, nPages }).first;
+
+            // Merge with the next free run.
+            auto next = std::next(it);
+            if (next != freeRuns_.end() && it->first + it->second == next->first) {
+
+                it->second += next->second;
+                freeRuns_.erase(next);
+
+            }
+
+            // Merge with the previous free run.
+            if (it != freeRuns_.begin()) {
+
+                auto previous = std::prev(it);
+                if (previous->first + previous->second == it->first) {
+
+                    previous->second += it->second;
+                    freeRuns_.erase(it);
+
+                }
+
+            }
+
+        }
+
+    }
+
+    void terrainRenderer::defragment_(unsigned int nPages) {
+
+        const unsigned int pageBytes = sizeof(chunkVertex) * TERRAIN_ARENA_PAGE_SIZE;
+
+        vertexBuffer* newArena = new vertexBuffer();
+        newArena->bind();
+        newArena->prepareDynamic(nPages * pageBytes);
+
+        std::vector<float> newPageOrigins(nPages * 4, 0.0f);
+
+        unsigned int nextPage = 0;
+        for (auto& mesh : meshes_)
+            if (mesh.second.nPages) {
+
+                newArena->copyData(*arena_, mesh.second.firstPage * pageBytes, nextPage * pageBytes, mesh.second.nPages * pageBytes);
+                std::copy(pageOrigins_.begin() + mesh.second.firstPage * 4, pageOrigins_.begin() + (mesh.second.firstPage + mesh.second.nPages) * 4,
+                          newPageOrigins.begin() + nextPage * 4);
+
+                mesh.second.firstPage = nextPage;
+                nextPage += mesh.second.nPages;
+
+            }
+
+        delete arena_;
+        arena_ = newArena;
+        pageOrigins_.swap(newPageOrigins);
+
+        arenaPages_ = nPages;
+        arenaFreePages_ = nPages - nextPage;
+        freeRuns_.clear();
+        if (arenaFreePages_)
+            freeRuns_[nextPage] = arenaFreePages_;
+
+        // Point the chunk vertex attribute to the new arena.
+        va_->bind();
+        arena_->bind();
+        va_->addLayout(*layout_, 3);
+        va_->unbind();
+
+        glBindBuffer(GL_TEXTURE_BUFFER, pageOriginsBuffer_);
+        glBufferData(GL_TEXTURE_BUFFER, pageOrigins_.size() * sizeof(float), pageOrigins_.data(), GL_DYNAMIC_DRAW);
+
+    }
+
+    void terrainRenderer::addDraw_(const gpuMesh& mesh) {
+
+        // Each mesh is drawn from the arena by offsetting the quad indices with its first vertex.
+        drawNIndices_.push_back(mesh.nVertices / CHUNK_VERTICES_PER_FACE * CHUNK_INDICES_PER_FACE);
+        drawBaseVertices_.push_back(mesh.firstPage * TERRAIN_ARENA_PAGE_SIZE);
+
+    }
+
+    void terrainRenderer::setPageOrigins_(unsigned int firstPage, unsigned int nPages, const vec3& origin) {
+
+        for (unsigned int page = firstPage; page < firstPage + nPages; page++) {
+
+            pageOrigins_[page * 4] = origin.x;
+            pageOrigins_[page * 4 + 1] = origin.y;
+            pageOrigins_[page * 4 + 2] = origin.z;
+
+        }
+
+        glBindBuffer(GL_TEXTURE_BUFFER, pageOriginsBuffer_);
+        glBufferSubData(GL_TEXTURE_BUFFER, firstPage * 4 * sizeof(float), nPages * 4 * sizeof(float), pageOrigins_.data() + firstPage * 4);
+
+    }
+
+}
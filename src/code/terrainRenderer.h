@@ -0,0 +1,290 @@
+/**
+* @file terrainRenderer.h
+* @version 1.0
+* @date 17/10/2026
+* @author Abdon Crespo Alvarez
+* @title Terrain renderer.
+* @brief Contains the declaration of the 'terrainRenderer' class.
+*/
+#ifndef _VOXELENG_TERRAINRENDERER_
+#define _VOXELENG_TERRAINRENDERER_
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include "camera.h"
+#include "chunk.h"
+#include "definitions.h"
+#include "indexBuffer.h"
+#include "renderer.h"
+#include "shader.h"
+#include "vertexArray.h"
+#include "vertexBuffer.h"
+#include "vertexBufferLayout.h"
+
+
+namespace VoxelEng {
+
+	//////////////
+	//Constants.//
+	//////////////
+
+	/**
+	* @brief Number of vertices in each page of the terrain vertex arena.
+	* Chunk meshes are sub-allocated from the arena in whole pages.
+	* WARNING. Must match the 'arenaPageSize' constant of the vertex shader.
+	*/
+	const unsigned int TERRAIN_ARENA_PAGE_SIZE = 128;
+
+	/**
+	* @brief Number of pages the terrain vertex arena is created with.
+	* The arena doubles its capacity whenever it runs out of free pages.
+	*/
+	const unsigned int TERRAIN_ARENA_INITIAL_PAGES = 8192;
+
+
+	////////////
+	//Classes.//
+	////////////
+
+	/**
+	* @brief Keeps the meshes of the drawable chunks in GPU memory and draws them.
+	* Each chunk's mesh is uploaded once per mesh version, so frames in which no
+	* chunk mesh changes do not upload any terrain geometry.
+	* All meshes are sub-allocated from a single vertex arena divided in pages of
+	* TERRAIN_ARENA_PAGE_SIZE vertices and drawn with a single draw call. The origin
+	* of the chunk that owns each page is stored in a buffer texture that the vertex
+	* shader indexes with the vertex's position in the arena.
+	* The chunks to draw are found with a breadth-first traversal from the camera's chunk
+	* that only crosses the chunks through pairs of faces connected by non-solid blocks
+	* (see 'chunkMeshData::faceConnectivity') and skips the chunks outside the view frustum.
+	* WARNING. All its methods must be called in the rendering thread.
+	*/
+	class terrainRenderer {
+
+	public:
+
+		// Initialisation.
+
+		/**
+		* @brief Initialise the terrain rendering system.
+		* WARNING. Must be called in a thread with valid graphics API context.
+		*/
+		static void init();
+
+
+		// Observers.
+
+		/**
+		* @brief Returns true if the system is initialised or false otherwise.
+		*/
+		static bool initialised();
+
+		/**
+		* @brief Returns the number of chunk meshes uploaded to the GPU since the
+		* system was initialised or its upload counters were last reset.
+		*/
+		static std::uint64_t nUploads();
+
+		/**
+		* @brief Returns the number of bytes of chunk meshes uploaded to the GPU since
+		* the system was initialised or its upload counters were last reset.
+		*/
+		static std::uint64_t nUploadedBytes();
+
+		/**
+		* @brief Returns the capacity of the terrain vertex arena in pages.
+		*/
+		static unsigned int arenaPages();
+
+		/**
+		* @brief Returns the number of free pages in the terrain vertex arena.
+		*/
+		static unsigned int arenaFreePages();
+
+		/**
+		* @brief Returns the number of chunks drawn in the last call to terrainRenderer::draw.
+		*/
+		static unsigned int nDrawnChunks();
+
+		/**
+		* @brief Returns the number of chunks culled in the last call to terrainRenderer::draw
+		* because they were outside the view frustum or hidden behind solid chunks.
+		*/
+		static unsigned int nCulledChunks();
+
+
+		// Modifiers.
+
+		/**
+		* @brief Makes the GPU copy of the chunk meshes match 'drawableChunks'. Only the meshes
+		* whose version differs from the one in GPU memory are uploaded, and the meshes of
+		* the chunks that are no longer drawable are freed.
+		* WARNING. Must be called in a thread with valid graphics API context.
+		*/
+		static void updateMeshes(const std::unordered_map<vec3, chunkMesh>& drawableChunks);
+
+		/**
+		* @brief Draws the chunk meshes in GPU memory that can be seen from 'viewCamera' with the specified shader in a single draw call.
+		* Chunks with no mesh in GPU memory are considered not to hide anything.
+		* WARNING. Must be called in a thread with valid graphics API context.
+		*/
+		static void draw(const renderer& graphicsRenderer, shader& chunkShader, const camera& viewCamera);
+
+		/**
+		* @brief Set to zero the upload counters.
+		*/
+		static void resetUploadCounters();
+
+
+		// Clean up.
+
+		/**
+		* @brief Frees the chunk meshes in GPU memory.
+		* WARNING. Must be called in a thread with valid graphics API context.
+		*/
+		static void clear();
+
+		/**
+		* @brief Frees any resources allocated by the system and deinitialises it.
+		* WARNING. Must be called in a thread with valid graphics API context.
+		*/
+		static void cleanUp();
+
+	private:
+
+		/*
+		Attributes.
+		*/
+
+		/*
+		A chunk mesh in GPU memory. It occupies 'nPages' consecutive
+		pages of the arena starting at page 'firstPage'.
+		*/
+		struct gpuMesh {
+
+			unsigned int firstPage,
+						 nPages,
+						 nVertices;
+			std::uint64_t version,
+						  faceConnectivity;
+
+		};
+
+		/*
+		A chunk reached by the visibility traversal, the face through which it was
+		entered (6 for the camera's chunk) and the directions taken to reach it (one bit per face).
+		*/
+		struct visibilityNode {
+
+			vec3 chunkPos;
+			unsigned int entryFace,
+						 directions;
+
+		};
+
+		static bool initialised_;
+		static std::unordered_map<vec3, gpuMesh> meshes_;
+		static vertexArray* va_;
+		static vertexBufferLayout* layout_;
+		static indexBuffer* ibo_;
+		static vertexBuffer* arena_;
+		static unsigned int arenaPages_,
+							arenaFreePages_,
+							nDrawnChunks_,
+							nCulledChunks_;
+		static std::map<unsigned int, unsigned int> freeRuns_; // First page of each free run of pages -> number of pages in the run.
+		static std::vector<float> pageOrigins_; // Origin of the chunk that owns each page (4 floats per page).
+		static GLuint pageOriginsBuffer_,
+					  pageOriginsTexture_;
+		static std::vector<GLsizei> drawNIndices_;
+		static std::vector<GLint> drawBaseVertices_;
+		static std::vector<const void*> drawFirstIndices_;
+		static vec3 minChunkPos_, // Bounds of the positions of the chunks with a mesh in GPU memory.
+					maxChunkPos_;
+		static std::vector<visibilityNode> visibilityQueue_;
+		static std::vector<bool> visitedChunks_;
+		static std::uint64_t nUploads_,
+							 nUploadedBytes_;
+
+
+		/*
+		Methods.
+		*/
+
+		/*
+		Sub-allocates 'nPages' consecutive pages from the arena with a first-fit policy.
+		If no free run is large enough, the arena is defragmented and, if that is not enough, grown.
+		Returns the first page allocated.
+		*/
+		static unsigned int allocatePages_(unsigned int nPages);
+
+		/*
+		Returns 'nPages' consecutive pages starting at 'firstPage' to the arena,
+		merging them with the free runs next to them.
+		*/
+		static void freePages_(unsigned int firstPage, unsigned int nPages);
+
+		/*
+		Moves all meshes to the beginning of a new arena with 'nPages' pages, leaving a single free run of pages at its end.
+		The meshes are copied in GPU memory.
+		*/
+		static void defragment_(unsigned int nPages);
+
+		/*
+		Stores 'origin' as the chunk origin of 'nPages' consecutive pages starting at 'firstPage'.
+		*/
+		static void setPageOrigins_(unsigned int firstPage, unsigned int nPages, const vec3& origin);
+
+		/*
+		Adds the specified mesh to the next draw call.
+		*/
+		static void addDraw_(const gpuMesh& mesh);
+
+	};
+
+	inline bool terrainRenderer::initialised() {
+
+		return initialised_;
+
+	}
+
+	inline std::uint64_t terrainRenderer::nUploads() {
+
+		return nUploads_;
+
+	}
+
+	inline std::uint64_t terrainRenderer::nUploadedBytes() {
+
+		return nUploadedBytes_;
+
+	}
+
+	inline unsigned int terrainRenderer::arenaPages() {
+
+		return arenaPages_;
+
+	}
+
+	inline unsigned int terrainRenderer::arenaFreePages() {
+
+		return arenaFreePages_;
+
+	}
+
+	inline unsigned int terrainRenderer::nDrawnChunks() {
+
+		return nDrawnChunks_;
+
+	}
+
+	inline unsigned int terrainRenderer::nCulledChunks() {
+
+		return nCulledChunks_;
+
+	}
+
+}
+
+#endif
@@ -0,0 +1,112 @@
+/**
+* @file lodBorderTest.cpp
+* @version 1.0
+* @date 17/10/2026
+* @author Abdon Crespo Alvarez
+* @title LOD border test.
+* @brief Checks that the mesh of a chunk at a level of detail other than 0 has no faces
+* outside the chunk at its positive borders, where the blocks of the neighbor chunks
+* used to leak into the chunk's face masks.
+*/
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+#include "../chunk.h"
+#include "../model.h"
+
+
+namespace {
+
+	//////////////
+	//Constants.//
+	//////////////
+
+	const unsigned int LOD = 1;
+
+
+	/////////////////////////
+	//Function definitions.//
+	/////////////////////////
+
+	/*
+	Returns the number of faces of the specified mesh whose vertices all lie at or beyond
+	the chunk's positive border along the specified axis (0 for X, 1 for Y and 2 for Z).
+	*/
+	unsigned int countFacesOutside(const std::vector<VoxelEng::chunkVertex>& vertices, unsigned int axis) {
+
+		unsigned int nFaces = 0,
+					 minCoord = 0;
+		for (std::size_t face = 0; face < vertices.size(); face += VoxelEng::CHUNK_VERTICES_PER_FACE) {
+
+			minCoord = VoxelEng::SCX;
+			for (std::size_t corner = face; corner < face + VoxelEng::CHUNK_VERTICES_PER_FACE; corner++)
+				minCoord = std::min<unsigned int>(minCoord, (vertices[corner].position >> (5 * axis)) & 31u);
+
+			if (minCoord >= VoxelEng::SCX)
+				nFaces++;
+
+		}
+
+		return nFaces;
+
+	}
+
+}
+
+
+int main() {
+
+	bool passed = true;
+
+	VoxelEng::models::init();
+	VoxelEng::chunk::init();
+	VoxelEng::chunkManager::init(2);
+
+	// The lower half of the chunk is filled with terrain, while its +X neighbor is solid
+	// and its +Y and +Z neighbors are missing, so that all of its positive borders are covered.
+	VoxelEng::chunk* selectedChunk = VoxelEng::chunkManager::createChunk(true, VoxelEng::vec3(0, 0, 0)),
+				   * neighborChunk = VoxelEng::chunkManager::createChunk(true, VoxelEng::vec3(1, 0, 0));
+
+	for (GLbyte x = 0; x < VoxelEng::SCX; x++)
+		for (GLbyte y = 0; y < VoxelEng::SCY / 2; y++)
+			for (GLbyte z = 0; z < VoxelEng::SCZ; z++)
+				selectedChunk->setBlock(x, y, z, 1 + (x + z) % 3);
+	neighborChunk->makeUniform(1);
+
+	VoxelEng::chunkManager::setChunkLOD(VoxelEng::vec3(0, 0, 0), LOD);
+	VoxelEng::chunkManager::setChunkLOD(VoxelEng::vec3(1, 0, 0), LOD);
+
+	selectedChunk->renewMesh();
+
+	const std::vector<VoxelEng::chunkVertex>& vertices = selectedChunk->renderingData().mesh->vertices;
+	const char* axes[3] = { "X", "Y", "Z" };
+	unsigned int nFacesOutside = 0;
+
+	std::cout << "Faces of the LOD " << LOD << " chunk: " << vertices.size() / VoxelEng::CHUNK_VERTICES_PER_FACE << std::endl;
+	for (unsigned int axis = 0; axis < 3; axis++) {
+
+		nFacesOutside = countFacesOutside(vertices, axis);
+		if (nFacesOutside) {
+
+			std::cout << "FAILED: " << nFacesOutside << " faces at " << axes[axis] << " >= " << VoxelEng::SCX << std::endl;
+			passed = false;
+
+		}
+
+	}
+
+	if (vertices.empty()) {
+
+		std::cout << "FAILED: the LOD " << LOD << " chunk has no mesh" << std::endl;
+		passed = false;
+
+	}
+
+	VoxelEng::chunkManager::cleanUp();
+
+	std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+
+	return passed ? 0 : 1;
+
+}
@@ -0,0 +1,179 @@
+/**
+* @file meshAllocationTest.cpp
+* @version 1.0
+* @date 17/10/2026
+* @author Abdon Crespo Alvarez
+* @title Mesh allocation test.
+* @brief Checks that remeshing a chunk in steady state does not allocate heap memory
+* and that the spare meshes of all chunks stay within CHUNK_MAX_SPARE_MESHES.
+* The global operator new is replaced to count the allocations made around chunk::renewMesh.
+*/
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <vector>
+#include "../chunk.h"
+#include "../model.h"
+
+
+namespace {
+
+	//////////////
+	//Constants.//
+	//////////////
+
+	const unsigned int WARM_UP_REMESHES = 8;
+	const unsigned int COUNTED_REMESHES = 1000;
+	const unsigned int N_BUDGET_CHUNKS = VoxelEng::CHUNK_MAX_SPARE_MESHES / 2 + 16;
+
+
+	//////////////
+	//Variables.//
+	//////////////
+
+	std::atomic<bool> countAllocations = false;
+	std::atomic<std::size_t> nAllocations = 0;
+
+
+	/////////////////////////
+	//Function definitions.//
+	/////////////////////////
+
+	/*
+	Fills the lower half of the chunk with a few different blocks, like terrain.
+	*/
+	void fillTerrain(VoxelEng::chunk& selectedChunk) {
+
+		for (GLbyte x = 0; x < VoxelEng::SCX; x++)
+			for (GLbyte y = 0; y < VoxelEng::SCY / 2; y++)
+				for (GLbyte z = 0; z < VoxelEng::SCZ; z++)
+					selectedChunk.setBlock(x, y, z, 1 + (x + z) % 3);
+
+	}
+
+	/*
+	Edits a block of the chunk and remeshes it. 'drawnMeshes' plays the part of the
+	two lists of drawable chunks of the rendering thread, which hold the last meshes.
+	The block is toggled between IDs already present in the chunk's palette, so that
+	the edit itself never reallocates the chunk's block data.
+	*/
+	void editAndRemesh(VoxelEng::chunk& selectedChunk, unsigned int i, VoxelEng::chunkMesh drawnMeshes[2]) {
+
+		selectedChunk.setBlock(5, VoxelEng::SCY / 2, 5, (i % 2) ? 1 : 0);
+		selectedChunk.renewMesh();
+		drawnMeshes[i % 2] = selectedChunk.renderingData().mesh;
+
+	}
+
+}
+
+
+//////////////////////////////////
+//Replaced allocation functions.//
+//////////////////////////////////
+
+void* operator new(std::size_t size) {
+
+	if (countAllocations)
+		nAllocations++;
+
+	if (void* memory = std::malloc(size ? size : 1))
+		return memory;
+	else
+		throw std::bad_alloc();
+
+}
+
+void operator delete(void* memory) noexcept {
+
+	std::free(memory);
+
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+
+	std::free(memory);
+
+}
+
+
+int main() {
+
+	bool passed = true;
+
+	VoxelEng::models::init();
+	VoxelEng::chunk::init();
+
+
+	// Steady state remeshing of a single chunk.
+	{
+
+		VoxelEng::chunk selectedChunk(true);
+		VoxelEng::chunkMesh drawnMeshes[2];
+
+		fillTerrain(selectedChunk);
+
+		for (unsigned int i = 0; i < WARM_UP_REMESHES; i++)
+			editAndRemesh(selectedChunk, i, drawnMeshes);
+
+		countAllocations = true;
+		for (unsigned int i = 0; i < COUNTED_REMESHES; i++)
+			editAndRemesh(selectedChunk, i, drawnMeshes);
+		countAllocations = false;
+
+		std::cout << "Allocations in " << COUNTED_REMESHES << " steady state remeshes: " << nAllocations << std::endl;
+		if (nAllocations) {
+
+			std::cout << "FAILED: remeshing a chunk in steady state allocated memory" << std::endl;
+			passed = false;
+
+		}
+
+	}
+
+
+	// Global spare mesh budget.
+	{
+
+		std::vector<std::unique_ptr<VoxelEng::chunk>> chunks;
+		VoxelEng::chunkMesh drawnMeshes[2];
+
+		for (unsigned int i = 0; i < N_BUDGET_CHUNKS; i++) {
+
+			chunks.push_back(std::make_unique<VoxelEng::chunk>(true));
+			fillTerrain(*chunks.back());
+
+			for (unsigned int j = 0; j < WARM_UP_REMESHES; j++)
+				editAndRemesh(*chunks.back(), j, drawnMeshes);
+
+		}
+
+		std::cout << "Spare meshes kept by " << N_BUDGET_CHUNKS << " chunks: " << VoxelEng::chunk::nSpareMeshes()
+				  << " (maximum " << VoxelEng::CHUNK_MAX_SPARE_MESHES << ")" << std::endl;
+		if (VoxelEng::chunk::nSpareMeshes() > VoxelEng::CHUNK_MAX_SPARE_MESHES) {
+
+			std::cout << "FAILED: the spare meshes of all chunks exceed CHUNK_MAX_SPARE_MESHES" << std::endl;
+			passed = false;
+
+		}
+
+		chunks.clear();
+		if (VoxelEng::chunk::nSpareMeshes()) {
+
+			std::cout << "FAILED: destroyed chunks did not return their spare meshes to the budget" << std::endl;
+			passed = false;
+
+		}
+
+	}
+
+	VoxelEng::chunkReclaimer::cleanUp();
+
+	std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+
+	return passed ? 0 : 1;
+
+}
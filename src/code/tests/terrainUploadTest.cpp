@@ -0,0 +1,132 @@
+/**
+* @file terrainUploadTest.cpp
+* @version 1.0
+* @date 17/10/2026
+* @author Abdon Crespo Alvarez
+* @title Terrain upload test.
+* @brief Checks that terrainRenderer::updateMeshes only uploads the chunk meshes whose
+* version changed since the last call. It runs in a hidden window, so it needs an
+* OpenGL 3.3 context but nothing is shown on screen.
+*/
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "../chunk.h"
+#include "../terrainRenderer.h"
+
+
+namespace {
+
+	/////////////////////////
+	//Function definitions.//
+	/////////////////////////
+
+	/*
+	Returns a new chunk mesh with the specified version and number of faces.
+	*/
+	VoxelEng::chunkMesh makeMesh(std::uint64_t version, unsigned int nFaces) {
+
+		VoxelEng::chunkMesh mesh = std::make_shared<VoxelEng::chunkMeshData>();
+		mesh->version = version;
+		mesh->vertices.resize(nFaces * VoxelEng::CHUNK_VERTICES_PER_FACE);
+
+		return mesh;
+
+	}
+
+	/*
+	Prints the result of the specified check and returns whether it passed.
+	*/
+	bool check(bool passed, const std::string& description) {
+
+		std::cout << (passed ? "PASSED: " : "FAILED: ") << description << std::endl;
+
+		return passed;
+
+	}
+
+}
+
+
+int main() {
+
+	bool passed = true;
+
+	if (!glfwInit()) {
+
+		std::cout << "FAILED: could not initialise GLFW" << std::endl;
+		return 1;
+
+	}
+
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+	GLFWwindow* window = glfwCreateWindow(64, 64, "terrainUploadTest", NULL, NULL);
+	if (!window) {
+
+		std::cout << "FAILED: could not create an OpenGL 3.3 context" << std::endl;
+		glfwTerminate();
+		return 1;
+
+	}
+
+	glfwMakeContextCurrent(window);
+	if (glewInit() != GLEW_OK) {
+
+		std::cout << "FAILED: could not initialise GLEW" << std::endl;
+		glfwTerminate();
+		return 1;
+
+	}
+
+	VoxelEng::terrainRenderer::init();
+
+	{
+
+		// Meshes without vertices are kept only for their face connectivity and never uploaded.
+		std::unordered_map<VoxelEng::vec3, VoxelEng::chunkMesh> drawableChunks = {
+
+			{ VoxelEng::vec3(0, 0, 0), makeMesh(1, 100) },
+			{ VoxelEng::vec3(1, 0, 0), makeMesh(2, 300) },
+			{ VoxelEng::vec3(0, 1, 0), makeMesh(3, 0) }
+
+		};
+
+		VoxelEng::terrainRenderer::updateMeshes(drawableChunks);
+
+		std::uint64_t nUploads = VoxelEng::terrainRenderer::nUploads(),
+					  nUploadedBytes = VoxelEng::terrainRenderer::nUploadedBytes();
+		passed &= check(nUploads == 2 && nUploadedBytes == sizeof(VoxelEng::chunkVertex) * 400 * VoxelEng::CHUNK_VERTICES_PER_FACE,
+						"the first update uploads every mesh with vertices");
+
+		VoxelEng::terrainRenderer::updateMeshes(drawableChunks);
+
+		passed &= check(VoxelEng::terrainRenderer::nUploads() == nUploads && VoxelEng::terrainRenderer::nUploadedBytes() == nUploadedBytes,
+						"updating with the same meshes uploads nothing");
+
+		drawableChunks[VoxelEng::vec3(1, 0, 0)] = makeMesh(4, 50);
+		VoxelEng::terrainRenderer::updateMeshes(drawableChunks);
+
+		passed &= check(VoxelEng::terrainRenderer::nUploads() == nUploads + 1 &&
+						VoxelEng::terrainRenderer::nUploadedBytes() == nUploadedBytes + sizeof(VoxelEng::chunkVertex) * 50 * VoxelEng::CHUNK_VERTICES_PER_FACE,
+						"a new mesh version only uploads that mesh");
+
+	}
+
+	VoxelEng::terrainRenderer::cleanUp();
+
+	glfwDestroyWindow(window);
+	glfwTerminate();
+
+	std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+
+	return passed ? 0 : 1;
+
+}
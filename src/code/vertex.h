@@ -38,6 +38,23 @@ namespace VoxelEng {
 
 	};
 
+	/**
+	* @brief Represents a vertex of a chunk's mesh in a compact form.
+	* 'position' packs, from its least significant bit, the vertex's chunk-local X, Y and Z
+	* coordinates (5 bits each), the index of the block face it belongs to (3 bits, in the order
+	* front, back, top, bottom, right and left) and its face-local texture coordinates (5 bits each).
+	* The last 4 bits are unused.
+	* 'textureID' is the ID of the face's texture, whose tile in the block texture atlas is found by the shader.
+	*/
+	struct chunkVertex {
+
+		GLuint position = 0;
+		GLuint textureID = 0;
+
+	};
+
+	static_assert(sizeof(chunkVertex) == 8, "Chunk vertices must be 8 bytes long");
+
 	/**
 	* @brief Represents a 2D vertex (usually used for drawing GUI).
 	*/
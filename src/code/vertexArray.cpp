@@ -28,7 +28,7 @@ namespace VoxelEng {
 
     }
 
-    void vertexArray::addLayout(const vertexBufferLayout& layout) {
+    void vertexArray::addLayout(const vertexBufferLayout& layout, unsigned int firstAttribute) {
 
         const std::vector<vertexBufferElement>& elements = layout.elements();
         unsigned int offset = 0;
@@ -37,14 +37,17 @@ namespace VoxelEng {
 
             vertexBufferElement element = elements[i];
 
-            glEnableVertexAttribArray(i);
+            glEnableVertexAttribArray(firstAttribute + i);
 
             // First parameter = attribute index.
             // Second parameter = number of values (bytes) that represent the attribute.
             // Third parameter = the type of what is representing the vertices (in this case float).
             // Fourth parameter = size of a vertex.
             // Fifth parameter = attributes offset (size to go to the second attribute if there is one. If not, simply put 0 in this parameter) (if you have to put a number, use const void * cast).
-            glVertexAttribPointer(i, element.count, element.type, element.is_normalized ? GL_TRUE : GL_FALSE, layout.stride(), (const void*) offset); 
+            if (element.is_integer)
+                glVertexAttribIPointer(firstAttribute + i, element.count, element.type, layout.stride(), (const void*) offset);
+            else
+                glVertexAttribPointer(firstAttribute + i, element.count, element.type, element.is_normalized ? GL_TRUE : GL_FALSE, layout.stride(), (const void*) offset); 
         
             offset += element.count * graphicsAPISizeOf(element.type);
 
@@ -52,9 +52,10 @@ namespace VoxelEng {
 		/**
 		* @brief Add a vertex buffer layout to the VAO so the GPU can figure out
 		* what is the data we sent to it.
+		* The layout's elements are bound to consecutive attribute indices starting from 'firstAttribute'.
 		* WARNING. Must be called in a thread with valid graphics API context.
 		*/
-		void addLayout(const vertexBufferLayout& layout);
+		void addLayout(const vertexBufferLayout& layout, unsigned int firstAttribute = 0);
 
 		/**
 		* @brief Submit vertex data from a vertex buffer object to an VAO which has been prepared for dynamic
@@ -35,6 +35,20 @@ namespace VoxelEng {
 
     }
 
+    void vertexBuffer::replaceDynamicData(const void* data, unsigned int size, unsigned int offset) {
+
+        glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+
+    }
+
+    void vertexBuffer::copyData(const vertexBuffer& source, unsigned int sourceOffset, unsigned int offset, unsigned int size) {
+
+        glBindBuffer(GL_COPY_READ_BUFFER, source.rendererID_);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, rendererID_);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, sourceOffset, offset, size);
+
+    }
+
     void vertexBuffer::bind() const {
 
         glBindBuffer(GL_ARRAY_BUFFER, rendererID_);
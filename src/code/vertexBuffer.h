@@ -62,6 +62,22 @@ namespace VoxelEng {
 		*/
 		void replaceDynamicData(const void* data, unsigned int size);
 
+		/**
+		* @brief Replaces 'size' bytes of the vertex's data, starting 'offset' bytes
+		* from the beginning of the buffer, with new ones.
+		* WARNING. Must be called in a thread with valid graphics API context.
+		* This vertex buffer must have been initialized as a dynamic geometry
+		* vertex buffer and be bound for this function to work as expected.
+		*/
+		void replaceDynamicData(const void* data, unsigned int size, unsigned int offset);
+
+		/**
+		* @brief Copies 'size' bytes of the 'source' buffer, starting 'sourceOffset' bytes from its beginning,
+		* into this buffer, starting 'offset' bytes from its beginning. The copy is performed in GPU memory.
+		* WARNING. Must be called in a thread with valid graphics API context.
+		*/
+		void copyData(const vertexBuffer& source, unsigned int sourceOffset, unsigned int offset, unsigned int size);
+
 		/**
 		* @brief Bind the vertex buffer for the next draw call.
 		* WARNING. Must be called in a thread with valid graphics API context.
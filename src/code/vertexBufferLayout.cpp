@@ -40,7 +40,7 @@ namespace VoxelEng {
 	void vertexBufferLayout::push<unsigned int>(unsigned int count)
 	{
 
-		elements_.push_back({ GL_UNSIGNED_INT, count, false });
+		elements_.push_back({ GL_UNSIGNED_INT, count, false, true });
 
 		stride_ += count * graphicsAPISizeOf(GL_UNSIGNED_INT);
 
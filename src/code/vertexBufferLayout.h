@@ -42,6 +42,7 @@ namespace VoxelEng {
 		unsigned int type;
 		unsigned int count;
 		bool is_normalized;
+		bool is_integer = false; // Integer elements are read as integers instead of being converted to floats.
 
 	};
 
@@ -97,6 +98,7 @@ namespace VoxelEng {
 
 		/**
 		* @brief Now the vertex data will have 'count' more unsigned ints at the end.
+		* Shaders read them as unsigned integers (uint/uvec types).
 		* Be aware that vertex data alignment must be of 4 bytes
 		*/
 		template <>
@@ -13,6 +13,7 @@ namespace VoxelEng {
 	std::mt19937 worldGen::generator_(worldGen::RD_());
 	std::uniform_int_distribution<unsigned int> worldGen::uDistribution_(0, std::numeric_limits<unsigned int>::max());
 	std::uniform_int_distribution<unsigned int>::param_type worldGen::flatWorldBlockDistribution_(1, 3);
+	thread_local std::mt19937 worldGen::chunkGenerator_;
 	std::atomic<bool> worldGen::isCreatingAllowed_ = false; // To restrict constructor's use.
 	bool worldGen::initialised_ = false;
 	std::unordered_map<std::string, worldGen*> worldGen::generators_;
@@ -71,6 +72,24 @@ namespace VoxelEng {
 			
 	}
 
+	void worldGen::generate(chunk& chunk) {
+
+		seedChunkGenerator_(chunk.chunkPos());
+		selectedGen_->generate_(chunk);
+
+	}
+
+	void worldGen::seedChunkGenerator_(const vec3& chunkPos) {
+
+		// Chunk coordinates can be negative, so they are converted to integers before being reinterpreted as unsigned.
+		std::seed_seq chunkSeed = { seed_,
+									static_cast<unsigned int>(static_cast<int>(chunkPos.x)),
+									static_cast<unsigned int>(static_cast<int>(chunkPos.y)),
+									static_cast<unsigned int>(static_cast<int>(chunkPos.z)) };
+		chunkGenerator_.seed(chunkSeed);
+
+	}
+
 	void worldGen::unregisterGen(const std::string& genName) {
 	
 		if (genName == "default")
@@ -124,11 +143,18 @@ namespace VoxelEng {
 	void defaultWorldGen::generate_(chunk& chunk) {
 
 		const vec3 chunkPos = chunk.chunkPos();
+		std::uniform_int_distribution<unsigned int> blockDistribution(flatWorldBlockDistribution_);
+
+		{
 
-		for (GLbyte x = 0; x < SCX; x++)
-			for (GLbyte y = 0; y < SCY; y++)
-				for (GLbyte z = 0; z < SCZ; z++)
-					chunk.setBlock(x, y, z, (chunkPos.y <= 8) * (uDistribution_(generator_, flatWorldBlockDistribution_)));
+			chunkEditSession session(chunk);
+
+			for (GLbyte x = 0; x < SCX; x++)
+				for (GLbyte y = 0; y < SCY; y++)
+					for (GLbyte z = 0; z < SCZ; z++)
+						session.setBlock(x, y, z, (chunkPos.y <= 8) * blockDistribution(chunkGenerator_));
+
+		}
 
 		chunk.setLoadLevel(VoxelEng::chunkLoadLevel::DECORATED);
 
@@ -140,6 +140,7 @@ namespace VoxelEng {
 
 		/**
 		* @brief Fill a chunk's block data according to the selected world generator.
+		* Can be called from several threads at once for different chunks.
 		*/
 		static void generate(chunk& chunk);
 
@@ -166,6 +167,14 @@ namespace VoxelEng {
 		static std::uniform_int_distribution<unsigned int> uDistribution_;
 		static std::uniform_int_distribution<unsigned int>::param_type flatWorldBlockDistribution_;
 
+		/*
+		Random number generator of the chunk that the calling thread is generating. It is seeded from the
+		level's seed and the chunk's position before each chunk is generated, so that chunks can be generated
+		on several threads at once and get the same blocks whatever the order they are generated in.
+		World generators must use it instead of 'generator_' in generate_().
+		*/
+		static thread_local std::mt19937 chunkGenerator_;
+
 
 		/*
 		Methods.
@@ -180,11 +189,18 @@ namespace VoxelEng {
 
 		/*
 		Chunk generation is done here.
+		WARNING. Can be called from several threads at once for different chunks.
 		*/
 		virtual void generate_(chunk& chunk) = 0;
 
 	private:
 
+		/*
+		Seeds the calling thread's 'chunkGenerator_' for the chunk with the specified chunk position.
+		*/
+		static void seedChunkGenerator_(const vec3& chunkPos);
+
+
 		static std::atomic<bool> isCreatingAllowed_; // To restrict constructor's use.
 		static bool initialised_;
 		static std::unordered_map<std::string, worldGen*> generators_;
@@ -254,12 +270,6 @@ namespace VoxelEng {
 	
 	}
 
-	inline void worldGen::generate(chunk& chunk) {
-
-		selectedGen_->generate_(chunk);
-	
-	}
-
 	
 	// 'defaultWorldGen' class.
 